@@ -0,0 +1,120 @@
+/*! @file abstract_factory_bench.cpp
+ *  @brief `ConcreteFactory` creation through the `AbstractFactory` interface against static dispatch.
+ *  @details The creator unit hands out preallocated products, so that only the dispatch is timed.
+ *  Also `PrototypeFactoryUnit` copies against `OpNewFactoryUnit` constructions parsing a configuration.
+ */
+
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "bench.hpp"
+#include "mosaic/utilities/abstract_factory.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    struct Button { virtual ~Button() = default; int id = 1; };
+    struct Window { virtual ~Window() = default; int id = 2; };
+    struct DarkButton : Button {};
+    struct DarkWindow : Window {};
+    struct LightButton : Button {};
+    struct LightWindow : Window {};
+
+    // Creator unit returning the same product every time.
+    template <class ConcreteProduct, class Base>
+    class RecycledUnit : public Base {
+        using BaseProductList = typename Base::ProductList;
+    protected:
+        using ProductList = typename BaseProductList::Tail;
+    public:
+        using AbstractProduct = typename BaseProductList::Head;
+        using Base::DoCreate;
+        ConcreteProduct* DoCreate(Type2Type<AbstractProduct>) { return &product_; }
+    private:
+        ConcreteProduct product_;
+    };
+
+    using Widgets = MakeTL<Button, Window>::TL;
+    using DarkWidgets = MakeTL<DarkButton, DarkWindow>::TL;
+    using LightWidgets = MakeTL<LightButton, LightWindow>::TL;
+    using WidgetFactory = AbstractFactory<Widgets>;
+
+    // Two concrete factories used alternately, so that the virtual calls are not devirtualized.
+    template <class Factory>
+    void create_widgets(Factory& factory, std::size_t i) {
+        bench::do_not_optimize(factory.template Create<Button>()->id);
+        bench::do_not_optimize(factory.template Create<Window>()->id);
+        bench::do_not_optimize(i);
+    }
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(AbstractFactory_Virtual) {
+    ConcreteFactory<WidgetFactory, RecycledUnit, DarkWidgets> dark;
+    ConcreteFactory<WidgetFactory, RecycledUnit, LightWidgets> light;
+    WidgetFactory* factories[] = {&dark, &light};
+    bench::do_not_optimize(factories);
+    for (std::size_t i = 0; i < n_ops; i += 2) {
+        create_widgets(*factories[(i / 2) & 1], i);
+    }
+}
+
+MOSAIC_BENCHMARK(AbstractFactory_Static) {
+    ConcreteFactory<StaticAbstractFactory<Widgets>, RecycledUnit, DarkWidgets> dark;
+    ConcreteFactory<StaticAbstractFactory<Widgets>, RecycledUnit, LightWidgets> light;
+    for (std::size_t i = 0; i < n_ops; i += 2) {
+        if ((i / 2) & 1) {
+            create_widgets(light, i);
+        } else {
+            create_widgets(dark, i);
+        }
+    }
+}
+
+
+namespace {
+
+    constexpr const char* config = "width=640 height=480 border=2 padding=4 margin=8 font=12 theme=dark";
+
+    struct Settings {
+        virtual ~Settings() = default;
+        std::map<std::string, std::string> values;
+    };
+
+    struct ParsedSettings : Settings {
+        ParsedSettings() {
+            std::istringstream in(config);
+            std::string entry;
+            while (in >> entry) {
+                const auto eq = entry.find('=');
+                values.emplace(entry.substr(0, eq), entry.substr(eq + 1));
+            }
+        }
+    };
+
+    using SettingsFactory = AbstractFactory<MakeTL<Settings>::TL>;
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(CreateSettings_OpNew) {
+    ConcreteFactory<SettingsFactory, OpNewFactoryUnit, MakeTL<ParsedSettings>::TL> factory;
+    SettingsFactory& settings = factory;
+    for (std::size_t i = 0; i < n_ops; ++i) {
+        std::unique_ptr<Settings> p(settings.Create<Settings>());
+        bench::do_not_optimize(p->values.size());
+    }
+}
+
+MOSAIC_BENCHMARK(CreateSettings_Prototype) {
+    ConcreteFactory<SettingsFactory, PrototypeFactoryUnit> factory;
+    SetPrototype<Settings>(factory, std::make_unique<ParsedSettings>());
+    SettingsFactory& settings = factory;
+    for (std::size_t i = 0; i < n_ops; ++i) {
+        std::unique_ptr<Settings> p(settings.Create<Settings>());
+        bench::do_not_optimize(p->values.size());
+    }
+}
@@ -0,0 +1,48 @@
+/*! @file arena_bench.cpp
+ *  @brief Request scoped `Functor`s in a `MonotonicArena` against the small-object allocator.
+ */
+
+#include <vector>
+#include "bench.hpp"
+#include "mosaic/utilities/arena.hpp"
+#include "mosaic/utilities/functor.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    constexpr std::size_t per_request = 64;
+
+    struct Handler {
+        long state[2];
+        long operator()(long i) const { return state[0] + i; }
+    };
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(Request_Functors_SmallObject) {
+    std::vector<Functor<long, long>> functors;
+    functors.reserve(per_request);
+    for (std::size_t done = 0; done < n_ops; done += per_request) {
+        for (std::size_t i = 0; i < per_request; ++i) {
+            functors.emplace_back(Handler{});
+        }
+        bench::do_not_optimize(functors.data());
+        functors.clear();
+    }
+}
+
+MOSAIC_BENCHMARK(Request_Functors_InlineArena) {
+    InlineArena<per_request * 64> arena;
+    std::vector<Functor<long, long>> functors;
+    functors.reserve(per_request);
+    for (std::size_t done = 0; done < n_ops; done += per_request) {
+        for (std::size_t i = 0; i < per_request; ++i) {
+            functors.emplace_back(std::allocator_arg, &arena, Handler{});
+        }
+        bench::do_not_optimize(functors.data());
+        functors.clear();
+        arena.reset();
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+/*! @file bench.hpp
+ *  @brief Minimal self-registering benchmark harness.
+ *  @details A benchmark is a function taking the number of operations to perform.
+ *  It is timed as a whole and reported as nanoseconds and millions of operations per second.
+ *  Multi-threaded benchmarks split the operations across threads with `run_threads()`.
+ *  Benchmarks timing something else than their body report it with `set_manual_time()`.
+ */
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+
+namespace mosaic::bench {
+
+    using BenchmarkFunction = void (*)(std::size_t n_ops);
+
+    /*! @brief Registers a benchmark at static initialization time.
+     */
+    struct Registration {
+        Registration(const char* name, BenchmarkFunction fun);
+    };
+
+    /*! @brief Report `elapsed_ns` for `n_ops` operations instead of timing the whole benchmark.
+     *  @details For benchmarks whose measured region is not the function body,
+     *  eg. the shutdown of a child process.
+     */
+    void set_manual_time(double elapsed_ns, std::size_t n_ops);
+
+    /*! @brief Prevent the optimizer from discarding `value`.
+     */
+    template <class T>
+    inline void do_not_optimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /*! @brief Run `fun(n_ops / n_threads)` on `n_threads` threads released at the same time.
+     */
+    template <class Fun>
+    void run_threads(std::size_t n_threads, std::size_t n_ops, Fun fun) {
+        std::vector<std::thread> threads;
+        threads.reserve(n_threads);
+        for (std::size_t i = 0; i < n_threads; ++i) {
+            threads.emplace_back(fun, n_ops / n_threads);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+} // end namespace `mosaic::bench`
+
+
+#define MOSAIC_BENCHMARK(name) \
+    static void name(std::size_t n_ops); \
+    static const ::mosaic::bench::Registration name##_registration(#name, &name); \
+    static void name([[maybe_unused]] std::size_t n_ops)
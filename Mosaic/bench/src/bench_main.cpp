@@ -0,0 +1,78 @@
+/*! @file bench_main.cpp
+ *  @brief Holds the `main` function for running the benchmarks.
+ *  @details Usage: `mosaicBench [filter] [n_ops]`. Runs benchmarks whose name contains `filter`.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench.hpp"
+
+namespace mosaic::bench {
+
+    namespace {
+
+        std::vector<std::pair<const char*, BenchmarkFunction>>& registry() {
+            static std::vector<std::pair<const char*, BenchmarkFunction>> s_registry;
+            return s_registry;
+        }
+
+        bool manual_time_set = false;
+        double manual_elapsed_ns = 0;
+        std::size_t manual_n_ops = 0;
+
+    } // end anonymous namespace
+
+    Registration::Registration(const char* name, BenchmarkFunction fun) {
+        registry().emplace_back(name, fun);
+    }
+
+    void set_manual_time(double elapsed_ns, std::size_t n_ops) {
+        manual_time_set = true;
+        manual_elapsed_ns = elapsed_ns;
+        manual_n_ops = n_ops;
+    }
+
+    namespace {
+
+        void run(const char* name, BenchmarkFunction fun, std::size_t n_ops) {
+            manual_time_set = false;
+
+            auto start = std::chrono::steady_clock::now();
+            fun(n_ops);
+            auto end = std::chrono::steady_clock::now();
+
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            if (manual_time_set) {
+                ns = manual_elapsed_ns;
+                n_ops = manual_n_ops;
+            }
+            std::printf("%-56s %14zu %10.3f %10.2f\n", name, n_ops, ns / n_ops, n_ops * 1e3 / ns);
+            std::fflush(stdout);    // Benchmarks may fork.
+        }
+
+    } // end anonymous namespace
+
+} // end namespace `mosaic::bench`
+
+
+int main(int argc, char **argv){
+
+    const char* filter = argc > 1 ? argv[1] : "";
+    std::size_t n_ops = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10'000'000;
+
+    std::printf("%-56s %14s %10s %10s\n", "benchmark", "ops", "ns/op", "Mops/s");
+    std::fflush(stdout);
+
+    for (auto& [name, fun] : mosaic::bench::registry()) {
+        if (std::strstr(name, filter)) {
+            mosaic::bench::run(name, fun, n_ops);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,244 @@
+/*! @file factory_bench.cpp
+ *  @brief `Factory::CreateObject` lookups against a `std::map` and an `std::unordered_map` of `std::function`s,
+ *  `CreateBatch` against `CreateObject` loops, `ConcurrentFactory` against a mutex guarded `Factory`, `StaticFactory` creations, and `CloneFactory` against an `std::unordered_map` keyed on `std::type_index`.
+ *  @details Creators return preallocated products, so that only the lookup and the creator call are timed,
+ *  except for the `Create_` benchmarks comparing `StaticFactory` and `Factory` with actual allocations.
+ */
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include "bench.hpp"
+#include "mosaic/utilities/factory.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    constexpr std::size_t n_types = 64;
+
+    struct Product {
+        virtual ~Product() = default;
+        int id = 0;
+    };
+
+    struct Registry {
+        Registry() : products(n_types) {
+            for (std::size_t i = 0; i < n_types; ++i) {
+                products[i].id = static_cast<int>(i);
+                names.push_back("product_type_" + std::to_string(i));
+            }
+        }
+        std::vector<Product> products;
+        std::vector<std::string> names;
+    };
+
+    Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    struct ProductA : Product {};
+    struct ProductB : Product {};
+    struct ProductC : Product {};
+    struct ProductD : Product {};
+    using Products = StaticFactory<MakeTL<ProductA, ProductB, ProductC, ProductD>::TL, Product>;
+
+    // Visit the identifiers in a scattered order.
+    template <class Create>
+    void create_all(std::size_t n_ops, Create create) {
+        for (std::size_t i = 0; i < n_ops; ++i) {
+            bench::do_not_optimize(create((i * 37) % n_types));
+        }
+    }
+
+    template <class Map>
+    void fill_std(Map& map) {
+        Registry& r = registry();
+        for (std::size_t i = 0; i < n_types; ++i) {
+            Product* p = &r.products[i];
+            map.emplace(r.names[i], [p] { return p; });
+        }
+    }
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(CreateObject_StdMap) {
+    std::map<std::string, std::function<Product*()>> map;
+    fill_std(map);
+    const auto& names = registry().names;
+    create_all(n_ops, [&](std::size_t i) { return map.find(names[i])->second(); });
+}
+
+MOSAIC_BENCHMARK(CreateObject_StdUnorderedMap) {
+    std::unordered_map<std::string, std::function<Product*()>> map;
+    fill_std(map);
+    const auto& names = registry().names;
+    create_all(n_ops, [&](std::size_t i) { return map.find(names[i])->second(); });
+}
+
+MOSAIC_BENCHMARK(CreateObject_Factory) {
+    Factory<Product, std::string> factory;
+    Registry& r = registry();
+    for (std::size_t i = 0; i < n_types; ++i) {
+        Product* p = &r.products[i];
+        factory.Register(r.names[i], [p] { return p; });
+    }
+    create_all(n_ops, [&](std::size_t i) { return factory.CreateObject(r.names[i]); });
+}
+
+MOSAIC_BENCHMARK(CreateObject_Factory_IntIds) {
+    Factory<Product, int> factory;
+    Registry& r = registry();
+    for (std::size_t i = 0; i < n_types; ++i) {
+        Product* p = &r.products[i];
+        factory.Register(static_cast<int>(i), [p] { return p; });
+    }
+    create_all(n_ops, [&](std::size_t i) { return factory.CreateObject(static_cast<int>(i)); });
+}
+
+MOSAIC_BENCHMARK(Create_StaticFactory) {
+    std::vector<int> ids(n_types);
+    for (std::size_t i = 0; i < n_types; ++i) {
+        ids[i] = static_cast<int>(i % 4);
+    }
+    create_all(n_ops, [&](std::size_t i) {
+        std::unique_ptr<Product> p(Products::Create(ids[i]));
+        return p->id;
+    });
+}
+
+MOSAIC_BENCHMARK(Create_Factory_IntIds) {
+    Factory<Product, int> factory;
+    factory.Register(0, [] () -> Product* { return new ProductA; });
+    factory.Register(1, [] () -> Product* { return new ProductB; });
+    factory.Register(2, [] () -> Product* { return new ProductC; });
+    factory.Register(3, [] () -> Product* { return new ProductD; });
+    std::vector<int> ids(n_types);
+    for (std::size_t i = 0; i < n_types; ++i) {
+        ids[i] = static_cast<int>(i % 4);
+    }
+    create_all(n_ops, [&](std::size_t i) {
+        std::unique_ptr<Product> p(factory.CreateObject(ids[i]));
+        return p->id;
+    });
+}
+
+MOSAIC_BENCHMARK(Clone_UnorderedMapTypeIndex) {
+    std::unordered_map<std::type_index, Product* (*)(const Product&)> map;
+    map.emplace(typeid(ProductA), [] (const Product& p) -> Product* { return new ProductA(static_cast<const ProductA&>(p)); });
+    map.emplace(typeid(ProductB), [] (const Product& p) -> Product* { return new ProductB(static_cast<const ProductB&>(p)); });
+    ProductA a;
+    ProductB b;
+    const Product* models[] = {&a, &b};
+    create_all(n_ops, [&](std::size_t i) {
+        const Product& model = *models[i % 2];
+        std::unique_ptr<Product> p(map.find(typeid(model))->second(model));
+        return p->id;
+    });
+}
+
+MOSAIC_BENCHMARK(Clone_CloneFactory) {
+    CloneFactory<Product> cloner;
+    cloner.Register<ProductA>();
+    cloner.Register<ProductB>();
+    ProductA a;
+    ProductB b;
+    const Product* models[] = {&a, &b};
+    create_all(n_ops, [&](std::size_t i) {
+        std::unique_ptr<Product> p(cloner.CreateObject(models[i % 2]));
+        return p->id;
+    });
+}
+
+namespace {
+
+    template <class FactoryT>
+    void register_int_ids(FactoryT& factory) {
+        Registry& r = registry();
+        for (std::size_t i = 0; i < n_types; ++i) {
+            Product* p = &r.products[i];
+            factory.Register(static_cast<int>(i), [p] { return p; });
+        }
+    }
+
+    void create_locked(std::size_t n_threads, std::size_t n_ops) {
+        Factory<Product, int> factory;
+        std::mutex mutex;
+        register_int_ids(factory);
+        bench::run_threads(n_threads, n_ops, [&](std::size_t n) {
+            create_all(n, [&](std::size_t i) {
+                std::lock_guard<std::mutex> lock(mutex);
+                return factory.CreateObject(static_cast<int>(i));
+            });
+        });
+    }
+
+    void create_concurrent(std::size_t n_threads, std::size_t n_ops) {
+        ConcurrentFactory<Product, int> factory;
+        register_int_ids(factory);
+        bench::run_threads(n_threads, n_ops, [&](std::size_t n) {
+            create_all(n, [&](std::size_t i) { return factory.CreateObject(static_cast<int>(i)); });
+        });
+    }
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(CreateObject_MutexFactory_1T) { create_locked(1, n_ops); }
+MOSAIC_BENCHMARK(CreateObject_MutexFactory_4T) { create_locked(4, n_ops); }
+MOSAIC_BENCHMARK(CreateObject_ConcurrentFactory_1T) { create_concurrent(1, n_ops); }
+MOSAIC_BENCHMARK(CreateObject_ConcurrentFactory_4T) { create_concurrent(4, n_ops); }
+
+namespace {
+
+    constexpr std::size_t batch_size = 1024;
+
+    struct Record : Product {
+        long fields[6] = {};
+    };
+
+    const Product* get(const Product* p) { return p; }
+    const Product* get(const std::unique_ptr<Product>& p) { return p.get(); }
+
+    // Create a batch, then touch every product, as an ingestion pass would.
+    template <class Create>
+    void ingest(std::size_t n_ops, Create create) {
+        for (std::size_t done = 0; done < n_ops; done += batch_size) {
+            long sum = 0;
+            for (const auto& p : create()) {
+                sum += get(p)->id;
+            }
+            bench::do_not_optimize(sum);
+        }
+    }
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(Ingest_CreateObjectLoop) {
+    Factory<Product, std::string> factory;
+    factory.Register("record", [] () -> Product* { return new Record; });
+    const std::string id = "record";
+    ingest(n_ops, [&] {
+        std::vector<std::unique_ptr<Product>> products;
+        products.reserve(batch_size);
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            products.emplace_back(factory.CreateObject(id));
+        }
+        return products;
+    });
+}
+
+MOSAIC_BENCHMARK(Ingest_CreateBatch_Pooled) {
+    Factory<Product, std::string> factory;
+    factory.Register<Record>("record", batch_size);
+    const std::string id = "record";
+    ingest(n_ops, [&] { return factory.CreateBatch(id, batch_size); });
+}
@@ -0,0 +1,145 @@
+/*! @file multi_methods_bench.cpp
+ *  @brief Double dispatch over random pairs of bodies: nested `dynamic_cast` chains against
+ *  `StaticDispatcher`, `BasicDispatcher` and `FnDispatcher`.
+ */
+
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include "bench.hpp"
+#include "mosaic/utilities/multi_methods.hpp"
+#include "mosaic/utilities/visitor.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    constexpr std::size_t n_pairs = 4096;
+
+    struct Asteroid;
+    struct Ship;
+    struct Station;
+    struct Debris;
+
+    using Bodies = MakeTL<Asteroid, Ship, Station, Debris>::TL;
+
+    struct Body : DenseVisitableBase<Bodies> {
+        virtual ~Body() = default;
+        double mass = 1.0;
+    };
+
+    struct Asteroid : DenseVisitable<Asteroid, Body> {};
+    struct Ship : DenseVisitable<Ship, Body> {};
+    struct Station : DenseVisitable<Station, Body> {};
+    struct Debris : DenseVisitable<Debris, Body> {};
+
+    // Depends on both types, so that no dispatch can be folded away.
+    template <class A, class B>
+    double energy(A& a, B& b) {
+        return a.mass * b.mass * double(1 + tl::IndexOf<Bodies, A>::value + 4 * tl::IndexOf<Bodies, B>::value);
+    }
+
+    template <class A>
+    double collide_with(A& a, Body& b) {
+        if (auto* p = dynamic_cast<Asteroid*>(&b)) return energy(a, *p);
+        if (auto* p = dynamic_cast<Ship*>(&b)) return energy(a, *p);
+        if (auto* p = dynamic_cast<Station*>(&b)) return energy(a, *p);
+        if (auto* p = dynamic_cast<Debris*>(&b)) return energy(a, *p);
+        return 0.0;
+    }
+
+    double collide_by_cast(Body& a, Body& b) {
+        if (auto* p = dynamic_cast<Asteroid*>(&a)) return collide_with(*p, b);
+        if (auto* p = dynamic_cast<Ship*>(&a)) return collide_with(*p, b);
+        if (auto* p = dynamic_cast<Station*>(&a)) return collide_with(*p, b);
+        if (auto* p = dynamic_cast<Debris*>(&a)) return collide_with(*p, b);
+        return 0.0;
+    }
+
+    struct Collide {
+        template <class A, class B>
+        double Fire(A& a, B& b) { return energy(a, b); }
+        double OnError(Body&, Body&) { return 0.0; }
+    };
+
+    template <class A, class B>
+    double collide_bodies(Body& a, Body& b) {
+        return energy(static_cast<A&>(a), static_cast<B&>(b));
+    }
+
+    template <class A, class B>
+    double collide_concrete(A& a, B& b) {
+        return energy(a, b);
+    }
+
+    std::unique_ptr<Body> random_body(std::mt19937& rng) {
+        switch (rng() % 4) {
+            case 0: return std::make_unique<Asteroid>();
+            case 1: return std::make_unique<Ship>();
+            case 2: return std::make_unique<Station>();
+            default: return std::make_unique<Debris>();
+        }
+    }
+
+    template <class Collider>
+    void collide_all(std::size_t n_ops, Collider collide) {
+        std::vector<std::pair<std::unique_ptr<Body>, std::unique_ptr<Body>>> pairs;
+        std::mt19937 rng(42);
+        for (std::size_t i = 0; i < n_pairs; ++i) {
+            auto a = random_body(rng);
+            pairs.emplace_back(std::move(a), random_body(rng));
+        }
+        double total = 0.0;
+        for (std::size_t done = 0; done < n_ops; done += n_pairs) {
+            for (auto& [a, b] : pairs) {
+                total += collide(*a, *b);
+            }
+        }
+        bench::do_not_optimize(total);
+    }
+
+    template <class A, class Dispatcher>
+    void add_row(Dispatcher& dispatcher) {
+        dispatcher.template Add<A, Asteroid>(&collide_bodies<A, Asteroid>);
+        dispatcher.template Add<A, Ship>(&collide_bodies<A, Ship>);
+        dispatcher.template Add<A, Station>(&collide_bodies<A, Station>);
+        dispatcher.template Add<A, Debris>(&collide_bodies<A, Debris>);
+    }
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(Dispatch_DynamicCastChains) {
+    collide_all(n_ops, [](Body& a, Body& b) { return collide_by_cast(a, b); });
+}
+
+MOSAIC_BENCHMARK(Dispatch_StaticDispatcher) {
+    using Dispatcher = StaticDispatcher<Collide, Body, Bodies, false, Body, Bodies, double>;
+    Collide collide;
+    collide_all(n_ops, [&collide](Body& a, Body& b) { return Dispatcher::Go(a, b, collide); });
+}
+
+MOSAIC_BENCHMARK(Dispatch_BasicDispatcher) {
+    BasicDispatcher<Body, Body, double> dispatcher;
+    add_row<Asteroid>(dispatcher);
+    add_row<Ship>(dispatcher);
+    add_row<Station>(dispatcher);
+    add_row<Debris>(dispatcher);
+    collide_all(n_ops, [&dispatcher](Body& a, Body& b) { return dispatcher.Go(a, b); });
+}
+
+MOSAIC_BENCHMARK(Dispatch_FnDispatcher) {
+    FnDispatcher<Body, Body, double> dispatcher;
+    dispatcher.Add<&collide_concrete<Asteroid, Asteroid>>();
+    dispatcher.Add<&collide_concrete<Asteroid, Ship>, true>();
+    dispatcher.Add<&collide_concrete<Asteroid, Station>, true>();
+    dispatcher.Add<&collide_concrete<Asteroid, Debris>, true>();
+    dispatcher.Add<&collide_concrete<Ship, Ship>>();
+    dispatcher.Add<&collide_concrete<Ship, Station>, true>();
+    dispatcher.Add<&collide_concrete<Ship, Debris>, true>();
+    dispatcher.Add<&collide_concrete<Station, Station>>();
+    dispatcher.Add<&collide_concrete<Station, Debris>, true>();
+    dispatcher.Add<&collide_concrete<Debris, Debris>>();
+    collide_all(n_ops, [&dispatcher](Body& a, Body& b) { return dispatcher.Go(a, b); });
+}
@@ -0,0 +1,57 @@
+/*! @file object_pool_bench.cpp
+ *  @brief `ObjectPool` recycling against `std::make_unique`, with and without a reset hook.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#include "mosaic/utilities/object_pool.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    constexpr std::size_t batch = 256;
+
+    struct Message {
+        std::vector<char> body;
+        long header[4];
+    };
+
+    struct ClearMessage {
+        void operator()(Message& message) const { message.body.clear(); }
+    };
+
+    // Each message gets a body, as a request handler would fill it.
+    template <class Acquire>
+    void churn(std::size_t n_ops, Acquire acquire) {
+        using Handle = decltype(acquire());
+        std::vector<Handle> live;
+        live.reserve(batch);
+        for (std::size_t done = 0; done < n_ops; done += batch) {
+            for (std::size_t i = 0; i < batch; ++i) {
+                live.push_back(acquire());
+                live.back()->body.resize(128);
+            }
+            bench::do_not_optimize(live.data());
+            live.clear();
+        }
+    }
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(Acquire_MakeUnique) {
+    churn(n_ops, [] { return std::make_unique<Message>(); });
+}
+
+MOSAIC_BENCHMARK(Acquire_ObjectPool_Destroy) {
+    ObjectPool<Message> pool;
+    churn(n_ops, [&pool] { return pool.acquire(); });
+}
+
+MOSAIC_BENCHMARK(Acquire_ObjectPool_Reset) {
+    ObjectPool<Message, ClearMessage> pool;
+    churn(n_ops, [&pool] { return pool.acquire(); });
+}
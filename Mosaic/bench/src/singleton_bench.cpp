@@ -0,0 +1,134 @@
+/*! @file singleton_bench.cpp
+ *  @brief Throughput of the hot `SingletonHolder::instance()` path, and shutdown time per lifetime policy.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "bench.hpp"
+#include "mosaic/utilities/singleton.hpp"
+#include "mosaic/utilities/singleton_registry.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    template <int id>
+    struct Payload {
+        int value = id;
+    };
+
+    template <class Holder>
+    void hot_instance(std::size_t n_threads, std::size_t n_ops) {
+        Holder::instance();     // Creation is not part of the hot path.
+
+        bench::run_threads(n_threads, n_ops, [](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                bench::do_not_optimize(&Holder::instance());
+            }
+        });
+    }
+
+    Payload<0>& meyers_instance() {
+        static Payload<0> s_instance;
+        return s_instance;
+    }
+
+    struct MeyersHolder {
+        static Payload<0>& instance() { return meyers_instance(); }
+    };
+
+    using SingleDefault = SingletonHolder<Payload<1>, policies::CreateUsingNew, policies::DefaultLifetime, policies::SingleThread>;
+    using LockableDefault = SingletonHolder<Payload<2>, policies::CreateUsingNew, policies::DefaultLifetime, policies::ClassLevelLockable>;
+    using SingleRegistry = SingletonHolder<Payload<3>, policies::CreateUsingNew, policies::RegistryLifetime, policies::SingleThread>;
+    using LockableRegistry = SingletonHolder<Payload<4>, policies::CreateUsingNew, policies::RegistryLifetime, policies::ClassLevelLockable>;
+    using SinglePhoenix = SingletonHolder<Payload<5>, policies::CreateUsingNew, policies::PhoenixSingleton, policies::SingleThread>;
+    using LockablePhoenix = SingletonHolder<Payload<6>, policies::CreateUsingNew, policies::PhoenixSingleton, policies::ClassLevelLockable>;
+    using SingleNoDestroy = SingletonHolder<Payload<7>, policies::CreateUsingNew, policies::NoDestroy, policies::SingleThread>;
+    using LockableNoDestroy = SingletonHolder<Payload<8>, policies::CreateUsingNew, policies::NoDestroy, policies::ClassLevelLockable>;
+
+
+    // Large singleton whose destructor frees many small nodes.
+    template <int id>
+    struct BigTable {
+        BigTable() {
+            for (int i = 0; i < 500'000; ++i) {
+                entries.emplace(i, i);
+            }
+        }
+        std::map<int, int> entries;
+    };
+
+    // Time from the end of a child's work until the child has fully exited.
+    template <class Holder>
+    void shutdown_time() {
+        constexpr int n_runs = 5;
+        double total_ns = 0;
+
+        for (int run = 0; run < n_runs; ++run) {
+            int ready[2];
+            if (::pipe(ready) != 0) {
+                std::abort();
+            }
+
+            pid_t child = ::fork();
+            if (child == 0) {
+                Holder::instance();
+                if (::write(ready[1], "r", 1) != 1) {
+                    std::_Exit(1);
+                }
+                std::exit(0);
+            }
+
+            char c;
+            if (::read(ready[0], &c, 1) != 1) {
+                std::abort();
+            }
+            auto start = std::chrono::steady_clock::now();
+            ::waitpid(child, nullptr, 0);
+            auto end = std::chrono::steady_clock::now();
+
+            total_ns += std::chrono::duration<double, std::nano>(end - start).count();
+            ::close(ready[0]);
+            ::close(ready[1]);
+        }
+
+        bench::set_manual_time(total_ns, n_runs);
+    }
+
+    using DefaultBigTable = SingletonHolder<BigTable<1>, policies::CreateUsingNew, policies::DefaultLifetime>;
+    using PhoenixBigTable = SingletonHolder<BigTable<2>, policies::CreateUsingNew, policies::PhoenixSingleton>;
+    using NoDestroyBigTable = SingletonHolder<BigTable<3>, policies::CreateUsingNew, policies::NoDestroy>;
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(FunctionLocalStatic_1T) { hot_instance<MeyersHolder>(1, n_ops); }
+MOSAIC_BENCHMARK(FunctionLocalStatic_4T) { hot_instance<MeyersHolder>(4, n_ops); }
+
+MOSAIC_BENCHMARK(SingletonHolder_SingleThread_DefaultLifetime_1T) { hot_instance<SingleDefault>(1, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_SingleThread_DefaultLifetime_4T) { hot_instance<SingleDefault>(4, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_ClassLevelLockable_DefaultLifetime_1T) { hot_instance<LockableDefault>(1, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_ClassLevelLockable_DefaultLifetime_4T) { hot_instance<LockableDefault>(4, n_ops); }
+
+MOSAIC_BENCHMARK(SingletonHolder_SingleThread_RegistryLifetime_1T) { hot_instance<SingleRegistry>(1, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_SingleThread_RegistryLifetime_4T) { hot_instance<SingleRegistry>(4, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_ClassLevelLockable_RegistryLifetime_1T) { hot_instance<LockableRegistry>(1, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_ClassLevelLockable_RegistryLifetime_4T) { hot_instance<LockableRegistry>(4, n_ops); }
+
+MOSAIC_BENCHMARK(SingletonHolder_SingleThread_PhoenixSingleton_1T) { hot_instance<SinglePhoenix>(1, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_SingleThread_PhoenixSingleton_4T) { hot_instance<SinglePhoenix>(4, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_ClassLevelLockable_PhoenixSingleton_1T) { hot_instance<LockablePhoenix>(1, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_ClassLevelLockable_PhoenixSingleton_4T) { hot_instance<LockablePhoenix>(4, n_ops); }
+
+MOSAIC_BENCHMARK(SingletonHolder_SingleThread_NoDestroy_1T) { hot_instance<SingleNoDestroy>(1, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_SingleThread_NoDestroy_4T) { hot_instance<SingleNoDestroy>(4, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_ClassLevelLockable_NoDestroy_1T) { hot_instance<LockableNoDestroy>(1, n_ops); }
+MOSAIC_BENCHMARK(SingletonHolder_ClassLevelLockable_NoDestroy_4T) { hot_instance<LockableNoDestroy>(4, n_ops); }
+
+// Reported per process shutdown.
+MOSAIC_BENCHMARK(Shutdown_DefaultLifetime) { shutdown_time<DefaultBigTable>(); }
+MOSAIC_BENCHMARK(Shutdown_PhoenixSingleton) { shutdown_time<PhoenixBigTable>(); }
+MOSAIC_BENCHMARK(Shutdown_NoDestroy) { shutdown_time<NoDestroyBigTable>(); }
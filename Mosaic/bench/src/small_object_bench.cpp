@@ -0,0 +1,102 @@
+/*! @file small_object_bench.cpp
+ *  @brief `SmallObject` allocation against `::operator new` for handler-sized objects.
+ */
+
+#include <array>
+#include <functional>
+#include <vector>
+#include "bench.hpp"
+#include "mosaic/utilities/allocator_stats.hpp"
+#include "mosaic/utilities/functor.hpp"
+#include "mosaic/utilities/small_object.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    constexpr std::size_t batch = 1000;
+
+    struct PlainHandler {
+        virtual ~PlainHandler() = default;
+        std::array<char, 24> payload;
+    };
+
+    struct SmallHandler : public SmallObject<> {
+        virtual ~SmallHandler() = default;
+        std::array<char, 24> payload;
+    };
+
+    struct SmallHandlerUnlocked : public SmallObject<policies::SingleThread> {
+        virtual ~SmallHandlerUnlocked() = default;
+        std::array<char, 24> payload;
+    };
+
+    // Allocate a batch, then free it, so that the allocator sees live objects.
+    template <class T>
+    void new_delete_batches(std::size_t n_ops) {
+        std::vector<T*> objects(batch);
+        for (std::size_t done = 0; done < n_ops; done += batch) {
+            for (auto& p : objects) {
+                p = new T();
+            }
+            bench::do_not_optimize(objects.data());
+            for (auto p : objects) {
+                delete p;
+            }
+        }
+    }
+
+    template <class T>
+    void new_delete_batches_threads(std::size_t n_threads, std::size_t n_ops) {
+        bench::run_threads(n_threads, n_ops, [](std::size_t n) { new_delete_batches<T>(n); });
+    }
+
+    // Captures large enough to defeat `std::function`'s small buffer.
+    struct Capture {
+        std::array<long, 4> values{};
+        long operator()(long i) const { return values[0] + i; }
+    };
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(NewDelete_OperatorNew_32B) { new_delete_batches<PlainHandler>(n_ops); }
+MOSAIC_BENCHMARK(NewDelete_SmallObject_ClassLevelLockable_32B) { new_delete_batches<SmallHandler>(n_ops); }
+MOSAIC_BENCHMARK(NewDelete_SmallObject_SingleThread_32B) { new_delete_batches<SmallHandlerUnlocked>(n_ops); }
+MOSAIC_BENCHMARK(NewDelete_SmallObject_Sampling_1in1000_32B) {
+    telemetry::Sampler::instance().start(1000);
+    new_delete_batches<SmallHandler>(n_ops);
+    telemetry::Sampler::instance().clear();
+}
+MOSAIC_BENCHMARK(NewDelete_OperatorNew_32B_4T) { new_delete_batches_threads<PlainHandler>(4, n_ops); }
+MOSAIC_BENCHMARK(NewDelete_SmallObject_ClassLevelLockable_32B_4T) { new_delete_batches_threads<SmallHandler>(4, n_ops); }
+
+MOSAIC_BENCHMARK(Construct_StdFunction_Heap) {
+    for (std::size_t i = 0; i < n_ops; ++i) {
+        std::function<long(long)> fun(Capture{});
+        bench::do_not_optimize(fun);
+    }
+}
+
+MOSAIC_BENCHMARK(Construct_Functor_SmallObject) {
+    for (std::size_t i = 0; i < n_ops; ++i) {
+        Functor<long, long> fun(Capture{});
+        bench::do_not_optimize(fun);
+    }
+}
+
+MOSAIC_BENCHMARK(Clone_StdFunction_Heap) {
+    std::function<long(long)> fun(Capture{});
+    for (std::size_t i = 0; i < n_ops; ++i) {
+        std::function<long(long)> copy(fun);
+        bench::do_not_optimize(copy);
+    }
+}
+
+MOSAIC_BENCHMARK(Clone_Functor_SmallObject) {
+    Functor<long, long> fun(Capture{});
+    for (std::size_t i = 0; i < n_ops; ++i) {
+        Functor<long, long> copy(fun.clone());
+        bench::do_not_optimize(copy);
+    }
+}
@@ -0,0 +1,79 @@
+/*! @file type_info_bench.cpp
+ *  @brief Lookups keyed on `TypeInfo`: `std::unordered_map` with the cached `std::hash<TypeInfo>`,
+ *  against rehashing `type_info::hash_code()` on every lookup, `std::map` and `FlatHashMap`.
+ */
+
+#include <cstddef>
+#include <map>
+#include <random>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "bench.hpp"
+#include "mosaic/utilities/flat_hash_map.hpp"
+#include "mosaic/utilities/type_info.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    constexpr std::size_t n_types = 32;
+    constexpr std::size_t n_lookups = 4096;
+
+    template <std::size_t i>
+    struct Tag {};
+
+    template <std::size_t... i>
+    std::vector<TypeInfo> make_types(std::index_sequence<i...>) {
+        return { TypeInfo(typeid(Tag<i>))... };
+    }
+
+    // What a hasher of the wrapped `type_info` computes, eg. hashing the name with libstdc++.
+    struct UncachedHash {
+        std::size_t operator()(const TypeInfo& t_info) const noexcept { return t_info.get().hash_code(); }
+    };
+
+    template <class Map>
+    void lookup_all(std::size_t n_ops) {
+        const std::vector<TypeInfo> types = make_types(std::make_index_sequence<n_types>{});
+        Map map;
+        for (std::size_t i = 0; i < n_types; ++i) {
+            map.emplace(types[i], int(i));
+        }
+        std::vector<TypeInfo> keys;
+        std::mt19937 rng(42);
+        for (std::size_t i = 0; i < n_lookups; ++i) {
+            keys.push_back(types[rng() % n_types]);
+        }
+        long total = 0;
+        for (std::size_t done = 0; done < n_ops; done += n_lookups) {
+            for (const TypeInfo& key : keys) {
+                if constexpr (std::is_same_v<Map, FlatHashMap<TypeInfo, int>>) {
+                    total += *map.find(key);
+                } else {
+                    total += map.find(key)->second;
+                }
+            }
+        }
+        bench::do_not_optimize(total);
+    }
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(TypeInfo_UnorderedMap_CachedHash) {
+    lookup_all<std::unordered_map<TypeInfo, int>>(n_ops);
+}
+
+MOSAIC_BENCHMARK(TypeInfo_UnorderedMap_UncachedHash) {
+    lookup_all<std::unordered_map<TypeInfo, int, UncachedHash>>(n_ops);
+}
+
+MOSAIC_BENCHMARK(TypeInfo_Map) {
+    lookup_all<std::map<TypeInfo, int>>(n_ops);
+}
+
+MOSAIC_BENCHMARK(TypeInfo_FlatHashMap) {
+    lookup_all<FlatHashMap<TypeInfo, int>>(n_ops);
+}
@@ -0,0 +1,158 @@
+/*! @file visitor_bench.cpp
+ *  @brief Visits of randomly interleaved shapes: `CyclicVisitor`, `DenseVisit()`,
+ *  `VisitAll()` and `ParallelVisitAll()` against a `dynamic_cast` chain.
+ */
+
+#include <memory>
+#include <random>
+#include <vector>
+#include "bench.hpp"
+#include "mosaic/utilities/parallel_visitor.hpp"
+#include "mosaic/utilities/visitor.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    constexpr std::size_t n_shapes = 4096;
+
+    struct Circle;
+    struct Square;
+    struct Triangle;
+    struct Hexagon;
+
+    using Shapes = MakeTL<Circle, Square, Triangle, Hexagon>::TL;
+    using ShapeVisitor = CyclicVisitor<double, Shapes>;
+
+    struct Shape {
+        virtual ~Shape() = default;
+        virtual double Accept(ShapeVisitor&) = 0;
+        double size = 1.0;
+    };
+
+    struct Circle : Shape { MOSAIC_DEFINE_CYCLIC_VISITABLE(ShapeVisitor) };
+    struct Square : Shape { MOSAIC_DEFINE_CYCLIC_VISITABLE(ShapeVisitor) };
+    struct Triangle : Shape { MOSAIC_DEFINE_CYCLIC_VISITABLE(ShapeVisitor) };
+    struct Hexagon : Shape { MOSAIC_DEFINE_CYCLIC_VISITABLE(ShapeVisitor) };
+
+    struct Area : ShapeVisitor {
+        double Visit(Circle& s) override { return 3.14 * s.size * s.size; }
+        double Visit(Square& s) override { return s.size * s.size; }
+        double Visit(Triangle& s) override { return 0.43 * s.size * s.size; }
+        double Visit(Hexagon& s) override { return 2.6 * s.size * s.size; }
+    };
+
+    double area_by_cast(Shape& s) {
+        if (auto* c = dynamic_cast<Circle*>(&s)) return 3.14 * c->size * c->size;
+        if (auto* q = dynamic_cast<Square*>(&s)) return q->size * q->size;
+        if (auto* t = dynamic_cast<Triangle*>(&s)) return 0.43 * t->size * t->size;
+        if (auto* h = dynamic_cast<Hexagon*>(&s)) return 2.6 * h->size * h->size;
+        return 0.0;
+    }
+
+    std::vector<std::unique_ptr<Shape>> random_shapes() {
+        std::vector<std::unique_ptr<Shape>> shapes;
+        std::mt19937 rng(42);
+        for (std::size_t i = 0; i < n_shapes; ++i) {
+            switch (rng() % 4) {
+                case 0: shapes.push_back(std::make_unique<Circle>()); break;
+                case 1: shapes.push_back(std::make_unique<Square>()); break;
+                case 2: shapes.push_back(std::make_unique<Triangle>()); break;
+                default: shapes.push_back(std::make_unique<Hexagon>()); break;
+            }
+        }
+        return shapes;
+    }
+
+    struct DenseCircle;
+    struct DenseSquare;
+    struct DenseTriangle;
+    struct DenseHexagon;
+
+    struct DenseShape : DenseVisitableBase<MakeTL<DenseCircle, DenseSquare, DenseTriangle, DenseHexagon>::TL> {
+        virtual ~DenseShape() = default;
+        double size = 1.0;
+    };
+
+    struct DenseCircle : DenseVisitable<DenseCircle, DenseShape> {};
+    struct DenseSquare : DenseVisitable<DenseSquare, DenseShape> {};
+    struct DenseTriangle : DenseVisitable<DenseTriangle, DenseShape> {};
+    struct DenseHexagon : DenseVisitable<DenseHexagon, DenseShape> {};
+
+    struct DenseArea {
+        double Visit(DenseCircle& s) { return 3.14 * s.size * s.size; }
+        double Visit(DenseSquare& s) { return s.size * s.size; }
+        double Visit(DenseTriangle& s) { return 0.43 * s.size * s.size; }
+        double Visit(DenseHexagon& s) { return 2.6 * s.size * s.size; }
+    };
+
+    // Accumulates, for `VisitAll()`.
+    struct DenseAreaSum {
+        template <class S>
+        void Visit(S& s) { total += DenseArea().Visit(s); }
+        double total = 0.0;
+    };
+
+    std::vector<std::unique_ptr<DenseShape>> random_dense_shapes() {
+        std::vector<std::unique_ptr<DenseShape>> shapes;
+        std::mt19937 rng(42);
+        for (std::size_t i = 0; i < n_shapes; ++i) {
+            switch (rng() % 4) {
+                case 0: shapes.push_back(std::make_unique<DenseCircle>()); break;
+                case 1: shapes.push_back(std::make_unique<DenseSquare>()); break;
+                case 2: shapes.push_back(std::make_unique<DenseTriangle>()); break;
+                default: shapes.push_back(std::make_unique<DenseHexagon>()); break;
+            }
+        }
+        return shapes;
+    }
+
+    template <class Visit, class Make = decltype(&random_shapes)>
+    void visit_all(std::size_t n_ops, Visit visit, Make make = &random_shapes) {
+        auto shapes = make();
+        double total = 0.0;
+        for (std::size_t done = 0; done < n_ops; done += n_shapes) {
+            for (auto& shape : shapes) {
+                total += visit(*shape);
+            }
+        }
+        bench::do_not_optimize(total);
+    }
+
+} // end anonymous namespace
+
+
+MOSAIC_BENCHMARK(Visit_DynamicCastChain) {
+    visit_all(n_ops, [](Shape& s) { return area_by_cast(s); });
+}
+
+MOSAIC_BENCHMARK(Visit_CyclicVisitor) {
+    Area area;
+    visit_all(n_ops, [&area](Shape& s) { return s.Accept(area); });
+}
+
+MOSAIC_BENCHMARK(Visit_DenseVisit) {
+    DenseArea area;
+    visit_all(n_ops, [&area](DenseShape& s) { return DenseVisit(area, s); }, &random_dense_shapes);
+}
+
+MOSAIC_BENCHMARK(Visit_VisitAll) {
+    auto shapes = random_dense_shapes();
+    DenseAreaSum area;
+    for (std::size_t done = 0; done < n_ops; done += n_shapes) {
+        VisitAll(shapes, area);
+    }
+    bench::do_not_optimize(area.total);
+}
+
+MOSAIC_BENCHMARK(Visit_ParallelVisitAll_4T) {
+    ThreadPool pool(4);
+    auto shapes = random_dense_shapes();
+    double total = 0.0;
+    for (std::size_t done = 0; done < n_ops; done += n_shapes) {
+        total += ParallelVisitAll(pool, shapes, DenseAreaSum(), [](DenseAreaSum& into, const DenseAreaSum& part) {
+            into.total += part.total;
+        }).total;
+    }
+    bench::do_not_optimize(total);
+}
@@ -0,0 +1,283 @@
+#pragma once
+
+/*! @file abstract_factory.hpp
+ *  @brief Provides `AbstractFactory` and `ConcreteFactory`, creating families of related products.
+ *  @details An abstract factory is an interface with one `Create<T>()` per abstract product of a
+ *  typelist, built as a `GenScatterHierarchy` of `AbstractFactoryUnit`s. A concrete factory is a
+ *  `GenLinearHierarchy` of creator units over the concrete products, implementing that interface.
+ *
+ *  @code
+ *  using WidgetFactory = AbstractFactory<MakeTL<Button, Window>::TL>;
+ *  using DarkFactory = ConcreteFactory<WidgetFactory, OpNewFactoryUnit, MakeTL<DarkButton, DarkWindow>::TL>;
+ *
+ *  std::unique_ptr<WidgetFactory> factory = std::make_unique<DarkFactory>();
+ *  Button* button = factory->Create<Button>();
+ *  @endcode
+ *
+ *  Creator units: `OpNewFactoryUnit` creates with `new`, `PrototypeFactoryUnit` copies a prototype
+ *  set at runtime.
+ *
+ *  When the concrete factory is known at compile time, `StaticAbstractFactory` replaces the
+ *  interface by a root without virtual functions. The same creator units then resolve
+ *  `ConcreteFactory::Create<T>()` statically, so creation inlines.
+ */
+
+
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include "hierarchy_generators.hpp"
+#include "markers.hpp"
+#include "type_id.hpp"
+#include "type_mapping.hpp"
+#include "typelist.hpp"
+
+
+namespace mosaic {
+
+    /*! @brief Interface unit of `AbstractFactory`, creating the abstract product `T`.
+     */
+    template <class T>
+    class AbstractFactoryUnit {
+
+    public:
+
+        virtual T* DoCreate(Type2Type<T>) = 0;
+        virtual ~AbstractFactoryUnit() = default;
+
+    };
+
+
+    /*! @brief Interface creating every abstract product of `TList` through `Create<T>()`.
+     *  @tparam Unit Interface unit for one product, declaring `virtual T* DoCreate(Type2Type<T>)`.
+     */
+    template <class TList, template <class> class Unit = AbstractFactoryUnit>
+    class AbstractFactory : public GenScatterHierarchy<TList, Unit> {
+
+    public:
+
+        using ProductList = TList;
+
+        template <class T>
+        T* Create() {
+            Unit<T>& unit = *this;
+            return unit.DoCreate(Type2Type<T>());
+        }
+
+    protected:
+
+        // Root of the `DoCreate()` overloads the creator units gather, hides the units' own ones.
+        template <class T>
+        T* DoCreate(Type2Type<T>) {
+            return Create<T>();
+        }
+
+    };
+
+
+    /*! @brief Root of a concrete factory without virtual functions, for static dispatch.
+     *  @details Use as the `AbstractFact` of a `ConcreteFactory` whose type is known wherever
+     *  products are created, eg. a template parameter. There is no common interface to pass around.
+     */
+    template <class TList>
+    class StaticAbstractFactory {
+
+    public:
+
+        using ProductList = TList;
+
+    protected:
+
+        template <class T>
+        T* DoCreate(Type2Type<T>) {
+            static_assert(AlwaysFalse<T>::value, "Type is not a product of this factory!");
+            return nullptr;
+        }
+
+    };
+
+    /**************************************************/
+
+    /*! @brief Creator unit of `ConcreteFactory`, creating `ConcreteProduct` with `new`.
+     *
+     *  @details Implements the creation of the first abstract product left in `Base::ProductList`,
+     *  and passes the remaining ones on to the next unit through its own `ProductList`.
+     *  Every creator unit follows this scheme, and gathers the `DoCreate()` overloads of its base.
+     */
+    template <class ConcreteProduct, class Base>
+    class OpNewFactoryUnit : public Base {
+
+    private:
+
+        using BaseProductList = typename Base::ProductList;
+
+    protected:
+
+        using ProductList = typename BaseProductList::Tail;
+
+    public:
+
+        using AbstractProduct = typename BaseProductList::Head;
+
+        using Base::DoCreate;
+
+        ConcreteProduct* DoCreate(Type2Type<AbstractProduct>) {
+            return new ConcreteProduct;
+        }
+
+    };
+
+
+    /*! @brief Prototype of one abstract product, held by a `PrototypeFactoryUnit`.
+     *  @details A concrete factory holds one per product, reach them with `SetPrototype<AbstractProduct>()`
+     *  and `GetPrototype<AbstractProduct>()`.
+     */
+    template <class AbstractProduct>
+    class PrototypeSlot {
+
+    public:
+
+        /*! @brief Replace the prototype, products are copies of `prototype` from now on.
+         *  @details The copy constructor of `T` is recorded with it, so `T` needs no `Clone()`.
+         *  `T` must be the dynamic type of `*prototype`, debug builds with RTTI check it.
+         */
+        template <class T>
+        void SetPrototype(std::unique_ptr<T> prototype) {
+            static_assert(std::is_base_of_v<AbstractProduct, T>, "Prototype does not derive from the abstract product!");
+            static_assert(std::is_copy_constructible_v<T>, "Prototype is not copy constructible!");
+#if MOSAIC_HAS_RTTI
+            if constexpr (std::is_polymorphic_v<T>) {
+                assert((!prototype || typeid(*prototype) == typeid(T)) && "Prototype would be sliced, pass it as its dynamic type");
+            }
+#endif
+            copy_ = prototype ? &copy<T> : nullptr;
+            prototype_ = std::move(prototype);
+        }
+
+        const AbstractProduct* GetPrototype() const noexcept { return prototype_.get(); }
+
+    protected:
+
+        PrototypeSlot() = default;
+        ~PrototypeSlot() = default;
+
+        // `nullptr` without a prototype.
+        AbstractProduct* clone() const {
+            return prototype_ ? copy_(*prototype_) : nullptr;
+        }
+
+    private:
+
+        template <class T>
+        static AbstractProduct* copy(const AbstractProduct& prototype) {
+            return new T(static_cast<const T&>(prototype));
+        }
+
+        std::unique_ptr<AbstractProduct> prototype_;
+        AbstractProduct* (*copy_)(const AbstractProduct&) = nullptr;
+
+    };
+
+
+    /*! @brief Creator unit of `ConcreteFactory`, copying the prototype set for its product.
+     *
+     *  @details For products expensive to build and cheap to copy, eg. holding parsed configuration:
+     *  the prototype is built once, creations only copy it. Prototypes can be replaced at any time,
+     *  which changes the products of a factory without changing its type.
+     *
+     *  @code
+     *  using PrototypeWidgets = ConcreteFactory<WidgetFactory, PrototypeFactoryUnit>;
+     *  PrototypeWidgets factory;
+     *  SetPrototype<Button>(factory, std::make_unique<DarkButton>(config));
+     *  Button* button = factory.Create<Button>();      // `nullptr` until a prototype is set.
+     *  @endcode
+     *
+     *  @tparam ConcreteProduct Only checked to derive from the abstract product, any prototype deriving
+     *  from the abstract product is accepted. Leave the concrete products of `ConcreteFactory` defaulted.
+     */
+    template <class ConcreteProduct, class Base>
+    class PrototypeFactoryUnit
+        : public Base,
+          public PrototypeSlot<typename Base::ProductList::Head>
+    {
+
+    private:
+
+        using BaseProductList = typename Base::ProductList;
+
+    protected:
+
+        using ProductList = typename BaseProductList::Tail;
+
+    public:
+
+        using AbstractProduct = typename BaseProductList::Head;
+
+        static_assert(std::is_base_of_v<AbstractProduct, ConcreteProduct>, "Product does not derive from the abstract product!");
+
+        using Base::DoCreate;
+
+        AbstractProduct* DoCreate(Type2Type<AbstractProduct>) {
+            return PrototypeSlot<AbstractProduct>::clone();
+        }
+
+    };
+
+
+    /*! @brief Set the prototype copied by `factory` to create `AbstractProduct`s.
+     */
+    template <class AbstractProduct, class Factory, class T>
+    void SetPrototype(Factory& factory, std::unique_ptr<T> prototype) {
+        PrototypeSlot<AbstractProduct>& slot = factory;
+        slot.SetPrototype(std::move(prototype));
+    }
+
+    /*! @return The prototype copied by `factory` to create `AbstractProduct`s, `nullptr` if none is set.
+     */
+    template <class AbstractProduct, class Factory>
+    const AbstractProduct* GetPrototype(const Factory& factory) noexcept {
+        const PrototypeSlot<AbstractProduct>& slot = factory;
+        return slot.GetPrototype();
+    }
+
+    /**************************************************/
+
+    /*! @brief Factory creating, for each abstract product of `AbstractFact`, the concrete
+     *  product at the same position in `TList`.
+     *
+     *  @tparam AbstractFact An `AbstractFactory` to implement, or a `StaticAbstractFactory`.
+     *  @tparam Creator Creator unit, eg. `OpNewFactoryUnit`.
+     *  @tparam TList Concrete products, in the order of `AbstractFact::ProductList`.
+     */
+    template <
+        class AbstractFact,
+        template <class, class> class Creator = OpNewFactoryUnit,
+        class TList = typename AbstractFact::ProductList
+    >
+    class ConcreteFactory
+        : public GenLinearHierarchy<typename tl::Reverse<TList>::Result, Creator, AbstractFact>
+    {
+
+        static_assert(
+            int(tl::Length<TList>::value) == int(tl::Length<typename AbstractFact::ProductList>::value),
+            "There must be one concrete product per abstract product!"
+        );
+
+    public:
+
+        using ProductList = typename AbstractFact::ProductList;
+        using ConcreteProductList = TList;
+
+        /*! @brief Create the product implementing `T`, returned as the creator unit returns it.
+         *  @details Statically dispatched with a `StaticAbstractFactory`, so the creation inlines.
+         */
+        template <class T>
+        auto Create() {
+            return this->DoCreate(Type2Type<T>());
+        }
+
+    };
+
+} // end namespace `mosaic`
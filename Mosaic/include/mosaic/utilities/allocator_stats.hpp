@@ -0,0 +1,158 @@
+#pragma once
+
+/*! @file allocator_stats.hpp
+ *  @brief Statistics reported by the library allocators, and sampling of allocation call sites.
+ *  @details Every allocator (`SmallObjAllocator` and `SmallObject`, `MonotonicArena`, `ObjectPool`)
+ *  has a `stats()` member returning an `AllocatorStats` snapshot. Counters are plain integers
+ *  owned by the allocator (or by a thread cache, reported with its batch transfers), so they cost
+ *  a few increments per allocation and a snapshot only copies them.
+ *
+ *  `telemetry::Sampler` additionally records the call stacks of one in `period` small-object
+ *  allocations while they are alive, which points at leaks and at the hot allocation sites.
+ */
+
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+// Call stacks are captured with glibc's `backtrace()` where available.
+#if __has_include(<execinfo.h>)
+    #define MOSAIC_HAS_BACKTRACE 1
+#else
+    #define MOSAIC_HAS_BACKTRACE 0
+#endif
+
+
+namespace mosaic {
+
+    struct SizeClassStats {
+        std::size_t block_size;     //!< `0` for the allocations forwarded to `::operator new`.
+        std::size_t allocations;    //!< Since construction.
+        std::size_t in_use;         //!< Blocks currently allocated.
+    };
+
+
+    /*! @brief Snapshot of the state of one allocator.
+     */
+    struct AllocatorStats {
+        std::size_t bytes_in_use = 0;       //!< Bytes of live allocations, at the block size serving them.
+        std::size_t peak_bytes = 0;         //!< Largest `bytes_in_use` seen by the allocator.
+        std::size_t bytes_reserved = 0;     //!< Obtained from the system or the upstream resource.
+        std::size_t slab_count = 0;
+        std::size_t allocations = 0;        //!< Since construction.
+
+        /*! @brief Lower bound of the blocks freed by another thread than the allocating one.
+         *  @details Blocks do not record their allocating thread. A free only counts once its thread
+         *  has freed more blocks of the size class than it allocated, so a thread freeing foreign
+         *  blocks while as many of its own are live elsewhere is not noticed.
+         */
+        std::size_t cross_thread_frees = 0;
+        std::vector<SizeClassStats> size_classes;
+
+        /*! @brief Share of the reserved memory not holding live objects, in `[0, 1]`.
+         *  @details Includes free blocks, blocks held by thread caches and unused slab tails.
+         */
+        double fragmentation() const noexcept {
+            if (bytes_reserved == 0 || bytes_in_use >= bytes_reserved) {
+                return 0.0;
+            }
+            return 1.0 - static_cast<double>(bytes_in_use) / static_cast<double>(bytes_reserved);
+        }
+    };
+
+} // end namespace `mosaic`
+
+
+namespace mosaic::telemetry {
+
+    struct CallSite {
+        static constexpr std::size_t max_depth = 8;
+
+        std::array<void*, max_depth> frames;    //!< Return addresses, innermost first, `nullptr` padded.
+        std::size_t allocations;                //!< Live sampled allocations from this stack.
+        std::size_t bytes;
+    };
+
+
+    /*! @brief Process wide sampler of small-object allocation call sites.
+     *
+     *  @details While recording, one in `period` allocations of every thread is recorded with
+     *  its call stack. A sample is dropped when its block is freed, so `live_call_sites()` lists
+     *  where the surviving (possibly leaked) memory was allocated. Scale the counts by `period()`
+     *  for an estimate of the totals.
+     *
+     *  Until `start()` is first called, the allocator hooks cost one relaxed load.
+     *
+     *  @note Never destroyed, so that frees during static destruction stay safe. Link with
+     *  `-rdynamic` for function names in `write_report()`.
+     *  @note Without `MOSAIC_HAS_BACKTRACE` samples carry no frames, and all of them are
+     *  grouped in a single call site.
+     */
+    class Sampler {
+
+    public:
+
+        static Sampler& instance();
+
+        Sampler(const Sampler&) = delete;
+        Sampler& operator=(const Sampler&) = delete;
+
+        /*! @brief `true` once sampling was started, until `clear()`.
+         */
+        static bool active() noexcept { return s_active.load(std::memory_order_relaxed); }
+
+        /*! @brief Record one in `period` allocations from now on.
+         */
+        void start(std::size_t period);
+
+        /*! @brief Stop recording new samples. Live samples are kept and still dropped when freed.
+         */
+        void stop() noexcept;
+
+        /*! @brief Stop and drop all samples.
+         */
+        void clear();
+
+        std::size_t period() const noexcept { return period_.load(std::memory_order_relaxed); }
+
+        void on_allocate(const void* p, std::size_t size);
+        void on_deallocate(const void* p) noexcept;
+
+        /*! @brief Live samples grouped by call stack, largest bytes first.
+         */
+        std::vector<CallSite> live_call_sites() const;
+
+        /*! @brief Write `live_call_sites()` with symbolized frames.
+         */
+        void write_report(std::ostream& os) const;
+
+    private:
+
+        Sampler() = default;
+
+        struct Sample {
+            std::size_t size;
+            std::array<void*, CallSite::max_depth> frames;
+        };
+
+        // Counting filter over sampled addresses, so that most frees skip the lock.
+        static constexpr std::size_t filter_size = 4096;
+        static std::size_t bucket(const void* p) noexcept;
+
+        static inline std::atomic<bool> s_active{false};
+
+        std::atomic<std::size_t> period_{0};
+        std::array<std::atomic<std::uint32_t>, filter_size> filter_{};
+        mutable std::mutex mutex_;
+        std::unordered_map<const void*, Sample> samples_;
+
+    };
+
+} // end namespace `mosaic::telemetry`
@@ -0,0 +1,148 @@
+#pragma once
+
+/*! @file arena.hpp
+ *  @brief Provides `MonotonicArena`, a bump allocating `std::pmr::memory_resource` for request scoped objects.
+ *  @details Objects created while serving one request are carved out of the arena and
+ *  released together by `reset()`, which only rewinds a pointer. Chunks obtained from the
+ *  upstream resource are kept for the next request, so a warmed up arena stops allocating.
+ *
+ *  Library components accept a `std::pmr::memory_resource*`, eg. `Functor(std::allocator_arg, &arena, fun)`.
+ */
+
+
+#include <cstddef>
+#include <memory_resource>
+#include "allocator_stats.hpp"
+
+
+namespace mosaic {
+
+    /*! @brief Monotonic (bump) allocator, compatible with `std::pmr`.
+     *
+     *  @details Memory is taken from, in order, the optional initial buffer, then the chunks
+     *  already obtained from upstream, then new upstream chunks of geometrically growing size.
+     *  `deallocate()` does nothing, memory is reclaimed by `reset()` or `release()`.
+     *
+     *  @note Not thread safe. Objects with non trivial destructors must still be destroyed
+     *  before `reset()`, the arena only reclaims their storage.
+     */
+    class MonotonicArena : public std::pmr::memory_resource {
+
+    public:
+
+        static constexpr std::size_t default_chunk_size = 4096;
+
+        explicit MonotonicArena(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+        /*! @param initial_chunk_size Size of the first upstream chunk.
+         */
+        MonotonicArena(std::size_t initial_chunk_size, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+        /*! @param buffer Used before any upstream chunk. Not owned, must outlive the arena.
+         */
+        MonotonicArena(void* buffer, std::size_t size, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+        MonotonicArena(const MonotonicArena&) = delete;
+        MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+        ~MonotonicArena() override;
+
+        /*! @brief Make all memory available again, keeping the upstream chunks. O(1).
+         */
+        void reset() noexcept;
+
+        /*! @brief Like `reset()`, and also return every upstream chunk.
+         */
+        void release() noexcept;
+
+        /*! @brief Bytes handed out since the last `reset()`, alignment padding included.
+         */
+        std::size_t bytes_used() const noexcept { return bytes_used_; }
+
+        /*! @brief Largest `bytes_used()` ever reached.
+         *  @details A lower bound for an initial buffer avoiding upstream allocations, not a guarantee:
+         *  the tails of chunks left behind for an allocation that did not fit are not counted, and
+         *  alignment padding depends on where the allocations land. Leave some margin.
+         */
+        std::size_t high_water_mark() const noexcept { return high_water_mark_; }
+
+        /*! @brief Bytes in the initial buffer and the upstream chunks.
+         */
+        std::size_t capacity() const noexcept { return capacity_; }
+
+        std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
+        /*! @brief Usage snapshot. Slabs are the upstream chunks, there are no size classes.
+         */
+        AllocatorStats stats() const;
+
+    protected:
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    private:
+
+        struct Chunk {
+            Chunk* next;
+            std::size_t size;   // Including this header.
+        };
+
+        static constexpr std::size_t header_size = (sizeof(Chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+        // Move to the next kept chunk, or a new one, with room for `bytes` at `alignment`.
+        void next_chunk(std::size_t bytes, std::size_t alignment);
+        void use_chunk(Chunk* chunk) noexcept;
+
+        std::pmr::memory_resource* upstream_;
+        char* buffer_;
+        std::size_t buffer_size_;
+        std::size_t initial_chunk_size_;
+        std::size_t next_chunk_size_;
+
+        Chunk* head_ = nullptr;
+        Chunk* current_ = nullptr;      // `nullptr` while still in the initial buffer.
+        char* ptr_ = nullptr;
+        char* end_ = nullptr;
+
+        std::size_t bytes_used_ = 0;
+        std::size_t high_water_mark_ = 0;
+        std::size_t capacity_ = 0;
+        std::size_t allocations_ = 0;
+        std::size_t chunk_count_ = 0;
+
+    };
+
+    /**************************************************/
+
+    namespace arena_internal {
+
+        // Base-from-member, so that the buffer exists before `MonotonicArena` is constructed.
+        template <std::size_t size>
+        struct InlineBuffer {
+            alignas(std::max_align_t) unsigned char storage_[size];
+        };
+
+    } // end `arena_internal` namespace
+
+
+    /*! @brief `MonotonicArena` with `inline_size` bytes of initial storage inside the object.
+     *  @details Suited to a stack allocated arena per request, sized from `high_water_mark()` with some margin.
+     */
+    template <std::size_t inline_size>
+    class InlineArena
+        : private arena_internal::InlineBuffer<inline_size>,
+          public MonotonicArena
+    {
+
+    public:
+
+        explicit InlineArena(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+            : MonotonicArena(this->storage_, inline_size, upstream)
+        {
+        }
+
+    };
+
+} // end namespace `mosaic`
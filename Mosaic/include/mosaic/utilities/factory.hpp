@@ -0,0 +1,543 @@
+#pragma once
+
+/*! @file factory.hpp
+ *  @brief Provides `Factory`, creating objects of a hierarchy from a runtime identifier, and
+ *  `ConcurrentFactory`, its variant for registrations concurrent with creations, `StaticFactory`,
+ *  its counterpart for a product set fixed at compile time, and `CloneFactory`, copying objects
+ *  as their dynamic type.
+ */
+
+
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "flat_hash_map.hpp"
+#include "functor.hpp"
+#include "object_pool.hpp"
+#include "rcu.hpp"
+#include "type_id.hpp"
+#include "type_info.hpp"
+#include "typelist.hpp"
+
+
+namespace mosaic {
+
+    namespace policies {
+
+        /*! @brief Default error policy of `Factory`, throws `Exception` on an unknown identifier.
+         *
+         *  @details An error policy provides `static AbstractProduct* OnUnknownType(const IdentifierType&)`,
+         *  whose result is returned by `CreateObject()`. It may also return `nullptr` or a default product.
+         */
+        template <typename IdentifierType, class AbstractProduct>
+        struct DefaultFactoryError {
+
+            class Exception : public std::exception {
+            public:
+                explicit Exception(const IdentifierType& id) : id_(id) {}
+                const char* what() const noexcept override { return "Unknown object type passed to Factory"; }
+                const IdentifierType& id() const noexcept { return id_; }
+            private:
+                IdentifierType id_;
+            };
+
+            static AbstractProduct* OnUnknownType(const IdentifierType& id) {
+                throw Exception(id);
+            }
+
+        };
+
+    } // end namespace `policies`
+
+
+    namespace factory_internal {
+
+        // Creates and releases batches of one concrete product type, type erased.
+        template <class AbstractProduct>
+        class BatchCreator {
+        public:
+            virtual ~BatchCreator() = default;
+            virtual void create(std::size_t n, std::vector<AbstractProduct*>& products) = 0;
+            virtual void release(AbstractProduct* const* products, std::size_t n) noexcept = 0;
+        };
+
+        template <class AbstractProduct, class ConcreteProduct>
+        class PooledBatchCreator : public BatchCreator<AbstractProduct> {
+
+        public:
+
+            explicit PooledBatchCreator(std::size_t objects_per_slab) : pool_(objects_per_slab) {}
+
+            void create(std::size_t n, std::vector<AbstractProduct*>& products) override {
+                products.reserve(products.size() + n);
+                try {
+                    for (std::size_t i = 0; i < n; ++i) {
+                        products.push_back(pool_.acquire().release());
+                    }
+                } catch (...) {
+                    release(products.data(), products.size());
+                    products.clear();
+                    throw;
+                }
+            }
+
+            void release(AbstractProduct* const* products, std::size_t n) noexcept override {
+                for (std::size_t i = 0; i < n; ++i) {
+                    Handle recycled(static_cast<ConcreteProduct*>(products[i]), typename Pool::Recycler(&pool_));
+                }
+            }
+
+        private:
+
+            using Pool = ObjectPool<ConcreteProduct>;
+            using Handle = typename Pool::Handle;
+
+            Pool pool_;
+
+        };
+
+    } // end `factory_internal` namespace
+
+
+    /*! @brief Products created together by `Factory::CreateBatch()`, destroyed with the batch.
+     *
+     *  @details Iterates over `AbstractProduct*`. The products of an identifier registered with
+     *  `Register<ConcreteProduct>()` come from its pool, in contiguous slabs. Others are created
+     *  one by one by the registered creator and deleted.
+     *
+     *  @note Must not outlive the factory, nor the registration of its identifier.
+     */
+    template <class AbstractProduct>
+    class ProductBatch {
+
+    public:
+
+        using iterator = typename std::vector<AbstractProduct*>::const_iterator;
+
+        ProductBatch() = default;
+
+        ProductBatch(ProductBatch&& other) noexcept
+            : products_(std::move(other.products_)), creator_(other.creator_)
+        {
+            other.products_.clear();
+        }
+
+        ProductBatch& operator=(ProductBatch&& other) noexcept {
+            if (this != &other) {
+                clear();
+                products_.swap(other.products_);
+                creator_ = other.creator_;
+            }
+            return *this;
+        }
+
+        ~ProductBatch() { clear(); }
+
+        iterator begin() const noexcept { return products_.begin(); }
+        iterator end() const noexcept { return products_.end(); }
+        AbstractProduct& operator[](std::size_t i) const noexcept { return *products_[i]; }
+        std::size_t size() const noexcept { return products_.size(); }
+        bool empty() const noexcept { return products_.empty(); }
+
+        /*! @brief Destroy the products.
+         */
+        void clear() noexcept {
+            if (creator_) {
+                creator_->release(products_.data(), products_.size());
+            } else {
+                for (AbstractProduct* product : products_) {
+                    delete product;
+                }
+            }
+            products_.clear();
+        }
+
+    private:
+
+        template <class, typename, typename, template <typename, class> class> friend class Factory;
+
+        explicit ProductBatch(factory_internal::BatchCreator<AbstractProduct>* creator) noexcept : creator_(creator) {}
+
+        std::vector<AbstractProduct*> products_;
+        factory_internal::BatchCreator<AbstractProduct>* creator_ = nullptr;    // `nullptr` for deleted products.
+
+    };
+
+    /**************************************************/
+
+    /*! @brief Object factory mapping identifiers to creators of `AbstractProduct` objects.
+     *
+     *  @details Creators are held in a `FlatHashMap`, so that `CreateObject()` costs one hash,
+     *  usually one cache miss, and the creator call.
+     *
+     *  Creators may take parameters, eg. `Factory<Shape, std::string, Functor<Shape*, double>>`,
+     *  they are forwarded by `CreateObject(id, args...)`.
+     *
+     *  `CreateBatch(id, n)` creates `n` products with a single lookup. Identifiers registered with
+     *  `Register<ConcreteProduct>(id)` get an `ObjectPool` of their own, which batches are taken from:
+     *  no allocation per product once the pool is warm, and products contiguous in memory.
+     *
+     *  @tparam ProductCreator Callable returning an `AbstractProduct*` (or a pointer convertible to it).
+     *  @tparam FactoryErrorPolicy Decides what `CreateObject()` does on an unregistered identifier.
+     *
+     *  @note Not thread safe. Registration is expected at startup, before concurrent creations.
+     */
+    template <
+        class AbstractProduct,
+        typename IdentifierType,
+        typename ProductCreator = Functor<AbstractProduct*>,
+        template <typename, class> class FactoryErrorPolicy = policies::DefaultFactoryError
+    >
+    class Factory : public FactoryErrorPolicy<IdentifierType, AbstractProduct> {
+
+    public:
+
+        /*! @return `false` if `id` is already registered, its creator is then kept.
+         */
+        bool Register(const IdentifierType& id, ProductCreator creator) {
+            return associations_.emplace(id, std::move(creator));
+        }
+
+        /*! @brief Register `new ConcreteProduct()` as the creator of `id`, with a pool for batches.
+         *  @param objects_per_slab Pool slab size, the largest run of contiguous products.
+         *  @return `false` if `id` is already registered, its creator is then kept.
+         */
+        template <class ConcreteProduct>
+        bool Register(const IdentifierType& id, std::size_t objects_per_slab = 256) {
+            static_assert(std::is_base_of_v<AbstractProduct, ConcreteProduct>, "Product does not derive from AbstractProduct!");
+            if (associations_.contains(id)) {
+                return false;
+            }
+            using Pooled = factory_internal::PooledBatchCreator<AbstractProduct, ConcreteProduct>;
+            return associations_.emplace(
+                id,
+                ProductCreator([] () -> AbstractProduct* { return new ConcreteProduct(); }),
+                std::make_unique<Pooled>(objects_per_slab)
+            );
+        }
+
+        /*! @return `false` if `id` was not registered.
+         */
+        bool Unregister(const IdentifierType& id) {
+            return associations_.erase(id);
+        }
+
+        bool IsRegistered(const IdentifierType& id) const {
+            return associations_.contains(id);
+        }
+
+        /*! @brief Call the creator registered for `id` with `args`.
+         *  @return The new object, or the result of `OnUnknownType(id)` if `id` is unregistered.
+         */
+        template <class... Args>
+        AbstractProduct* CreateObject(const IdentifierType& id, Args&&... args) {
+            if (Association* association = associations_.find(id)) {
+                return association->creator(std::forward<Args>(args)...);
+            }
+            return this->OnUnknownType(id);
+        }
+
+        /*! @brief Create `n` products of identifier `id`, looking it up once.
+         *  @return The products, or an empty batch if `id` is unregistered and `OnUnknownType(id)`
+         *  returns, in which case its result is deleted.
+         */
+        ProductBatch<AbstractProduct> CreateBatch(const IdentifierType& id, std::size_t n) {
+            Association* association = associations_.find(id);
+            if (!association) {
+                std::unique_ptr<AbstractProduct> discarded(this->OnUnknownType(id));
+                return {};
+            }
+            ProductBatch<AbstractProduct> batch(association->pool.get());
+            if (association->pool) {
+                association->pool->create(n, batch.products_);
+            } else {
+                batch.products_.reserve(n);
+                for (std::size_t i = 0; i < n; ++i) {
+                    batch.products_.push_back(association->creator());
+                }
+            }
+            return batch;
+        }
+
+        /*! @brief Registered identifiers, in unspecified order.
+         */
+        std::vector<IdentifierType> RegisteredIds() const {
+            std::vector<IdentifierType> ids;
+            ids.reserve(associations_.size());
+            associations_.for_each([&ids](const IdentifierType& id, const Association&) { ids.push_back(id); });
+            return ids;
+        }
+
+    private:
+
+        struct Association {
+            explicit Association(ProductCreator c, std::unique_ptr<factory_internal::BatchCreator<AbstractProduct>> p = nullptr)
+                : creator(std::move(c)), pool(std::move(p)) {}
+
+            ProductCreator creator;
+            std::unique_ptr<factory_internal::BatchCreator<AbstractProduct>> pool;    // Only for `Register<ConcreteProduct>()`.
+        };
+
+        FlatHashMap<IdentifierType, Association> associations_;
+
+    };
+
+    /**************************************************/
+
+    /*! @brief `Factory` whose creations run concurrently with registrations, without locking.
+     *
+     *  @details The associations are an immutable `FlatHashMap` snapshot published by an `RcuCell`.
+     *  `CreateObject()` is wait-free up to the creator call: it increments a per-thread reader
+     *  counter, looks the creator up in the current snapshot and calls it. `Register()` and
+     *  `Unregister()` copy the snapshot, publish the new one and wait until no creation uses the
+     *  old one, so they cost O(registered ids) and are meant for startup and plugin loading.
+     *
+     *  @note Creators must be copyable, and must not register or unregister in the same factory.
+     */
+    template <
+        class AbstractProduct,
+        typename IdentifierType,
+        typename ProductCreator = Functor<AbstractProduct*>,
+        template <typename, class> class FactoryErrorPolicy = policies::DefaultFactoryError
+    >
+    class ConcurrentFactory : public FactoryErrorPolicy<IdentifierType, AbstractProduct> {
+
+    private:
+
+        using Associations = FlatHashMap<IdentifierType, ProductCreator>;
+
+    public:
+
+        /*! @return `false` if `id` is already registered, its creator is then kept.
+         */
+        bool Register(const IdentifierType& id, ProductCreator creator) {
+            bool registered = false;
+            associations_.update([&](const Associations& current) -> std::unique_ptr<Associations> {
+                if (current.contains(id)) {
+                    return nullptr;
+                }
+                auto next = copy(current, current.size() + 1);
+                registered = next->emplace(id, std::move(creator));
+                return next;
+            });
+            return registered;
+        }
+
+        /*! @return `false` if `id` was not registered.
+         */
+        bool Unregister(const IdentifierType& id) {
+            bool unregistered = false;
+            associations_.update([&](const Associations& current) -> std::unique_ptr<Associations> {
+                if (!current.contains(id)) {
+                    return nullptr;
+                }
+                auto next = copy(current, current.size());
+                unregistered = next->erase(id);
+                return next;
+            });
+            return unregistered;
+        }
+
+        bool IsRegistered(const IdentifierType& id) const {
+            return associations_.read([&](const Associations& current) { return current.contains(id); });
+        }
+
+        /*! @brief Call the creator registered for `id` with `args`.
+         *  @return The new object, or the result of `OnUnknownType(id)` if `id` is unregistered.
+         */
+        template <class... Args>
+        AbstractProduct* CreateObject(const IdentifierType& id, Args&&... args) {
+            bool found = false;
+            AbstractProduct* product = associations_.read([&](const Associations& current) -> AbstractProduct* {
+                if (const ProductCreator* creator = current.find(id)) {
+                    found = true;
+                    return (*creator)(std::forward<Args>(args)...);
+                }
+                return nullptr;
+            });
+            return found ? product : this->OnUnknownType(id);
+        }
+
+        /*! @brief Identifiers registered in the current snapshot, in unspecified order.
+         */
+        std::vector<IdentifierType> RegisteredIds() const {
+            return associations_.read([](const Associations& current) {
+                std::vector<IdentifierType> ids;
+                ids.reserve(current.size());
+                current.for_each([&ids](const IdentifierType& id, const ProductCreator&) { ids.push_back(id); });
+                return ids;
+            });
+        }
+
+    private:
+
+        static std::unique_ptr<Associations> copy(const Associations& current, std::size_t capacity) {
+            auto next = std::make_unique<Associations>(capacity);
+            current.for_each([&next](const IdentifierType& id, const ProductCreator& creator) { next->emplace(id, creator); });
+            return next;
+        }
+
+        RcuCell<Associations> associations_;
+
+    };
+
+    /**************************************************/
+
+    /*! @brief Factory of the products in a typelist, identified by their dense index in it.
+     *
+     *  @details The identifier of `TList`'s `i`-th type is `i`, or the enumerator of value `i`
+     *  with an enum `IdentifierType`. `Create(id)` is a bounds check and one indirect call
+     *  through a `constexpr` table of creators, generated from `tl::Length` and `tl::TypeAt`.
+     *  Nothing is registered at runtime, so there is no initialization order to get wrong.
+     *
+     *  @code
+     *  enum class ShapeId { circle, square };
+     *  using Shapes = StaticFactory<MakeTL<Circle, Square>::TL, Shape, ShapeId>;
+     *  Shape* s = Shapes::Create(ShapeId::square);
+     *  @endcode
+     *
+     *  @note Every type of `TList` must be constructible from the arguments passed to `Create()`.
+     */
+    template <
+        class TList,
+        class AbstractProduct,
+        typename IdentifierType = int,
+        template <typename, class> class FactoryErrorPolicy = policies::DefaultFactoryError
+    >
+    class StaticFactory : public FactoryErrorPolicy<IdentifierType, AbstractProduct> {
+
+    public:
+
+        static constexpr std::size_t size = tl::Length<TList>::value;
+
+        /*! @brief Identifier of the product `T`.
+         */
+        template <class T>
+        static constexpr IdentifierType IdOf() noexcept {
+            static_assert(tl::IndexOf<TList, T>::value != -1, "Type is not a product of this factory!");
+            return static_cast<IdentifierType>(tl::IndexOf<TList, T>::value);
+        }
+
+        /*! @brief `new T(args...)`, with `T` the product identified by `id`.
+         *  @return The new object, or the result of `OnUnknownType(id)` if `id` is out of range.
+         */
+        template <class... Args>
+        static AbstractProduct* Create(IdentifierType id, Args&&... args) {
+            const auto i = static_cast<std::size_t>(id);
+            if (i < size) {
+                return creators<Args&&...>[i](std::forward<Args>(args)...);
+            }
+            return StaticFactory::OnUnknownType(id);
+        }
+
+    private:
+
+        template <std::size_t i, class... Args>
+        static AbstractProduct* create(Args... args) {
+            using Product = typename tl::TypeAt<TList, static_cast<int>(i)>::Result;
+            static_assert(std::is_base_of_v<AbstractProduct, Product>, "Product does not derive from AbstractProduct!");
+            return new Product(std::forward<Args>(args)...);
+        }
+
+        template <class... Args, std::size_t... i>
+        static constexpr auto make_creators(std::index_sequence<i...>) noexcept {
+            return std::array<AbstractProduct* (*)(Args...), size>{{ &create<i, Args...>... }};
+        }
+
+        // One table per argument list, constant initialized.
+        template <class... Args>
+        static constexpr auto creators = make_creators<Args...>(std::make_index_sequence<size>{});
+
+    };
+
+    /**************************************************/
+
+    /*! @brief Factory copying `AbstractProduct` objects as their dynamic type.
+     *
+     *  @details Copy creators are registered for the dynamic types of the models, and found
+     *  from `typeid(*model)`. The map hashes the key once per lookup and compares the
+     *  `type_info` addresses before their names. Without RTTI, `policies::TypeIdKey` finds them
+     *  from `model->type_id()` instead.
+     *
+     *  @code
+     *  CloneFactory<Shape> cloner;
+     *  cloner.Register<Circle>();
+     *  Shape* copy = cloner.CreateObject(shape);
+     *  @endcode
+     *
+     *  @tparam ProductCreator Callable `AbstractProduct*(const AbstractProduct&)`. A function
+     *  pointer by default, which `Register<T>()` provides without allocating a handler.
+     *  @tparam TypeKey Type key policy, `policies::TypeInfoKey` by default, `policies::TypeIdKey` without RTTI.
+     *
+     *  @note Not thread safe. Registration is expected at startup, before concurrent creations.
+     */
+    template <
+        class AbstractProduct,
+        typename ProductCreator = AbstractProduct* (*)(const AbstractProduct&),
+        template <typename, class> class FactoryErrorPolicy = policies::DefaultFactoryError,
+        class TypeKey = policies::DefaultTypeKey
+    >
+    class CloneFactory : public FactoryErrorPolicy<typename TypeKey::KeyType, AbstractProduct> {
+
+    public:
+
+        using KeyType = typename TypeKey::KeyType;
+
+        /*! @return `false` if `t_info` is already registered, its creator is then kept.
+         */
+        bool Register(const KeyType& t_info, ProductCreator creator) {
+            return associations_.emplace(t_info, std::move(creator));
+        }
+
+        /*! @brief Register the copy constructor of `ConcreteProduct`.
+         */
+        template <class ConcreteProduct>
+        bool Register() {
+            static_assert(std::is_base_of_v<AbstractProduct, ConcreteProduct>, "Product does not derive from AbstractProduct!");
+            return Register(TypeKey::template OfType<ConcreteProduct>(), &copy<ConcreteProduct>);
+        }
+
+        /*! @return `false` if `t_info` was not registered.
+         */
+        bool Unregister(const KeyType& t_info) {
+            return associations_.erase(t_info);
+        }
+
+        bool IsRegistered(const KeyType& t_info) const {
+            return associations_.contains(t_info);
+        }
+
+        /*! @brief Copy of `model` as its dynamic type.
+         *  @return `nullptr` if `model` is, or the result of `OnUnknownType` if its type is unregistered.
+         */
+        AbstractProduct* CreateObject(const AbstractProduct* model) {
+            if (!model) {
+                return nullptr;
+            }
+            const KeyType t_info = TypeKey::OfObject(*model);
+            if (ProductCreator* creator = associations_.find(t_info)) {
+                return (*creator)(*model);
+            }
+            return this->OnUnknownType(t_info);
+        }
+
+        AbstractProduct* CreateObject(const AbstractProduct& model) {
+            return CreateObject(&model);
+        }
+
+    private:
+
+        template <class ConcreteProduct>
+        static AbstractProduct* copy(const AbstractProduct& model) {
+            return new ConcreteProduct(static_cast<const ConcreteProduct&>(model));
+        }
+
+        FlatHashMap<KeyType, ProductCreator> associations_;
+
+    };
+
+} // end namespace `mosaic`
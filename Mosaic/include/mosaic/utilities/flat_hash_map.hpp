@@ -0,0 +1,259 @@
+#pragma once
+
+/*! @file flat_hash_map.hpp
+ *  @brief Provides `FlatHashMap`, an open addressing hash map storing its entries inline.
+ */
+
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace mosaic {
+
+    /*! @brief Hash map with linear probing over a single array of slots.
+     *
+     *  @details Each slot holds the key, the value and the full hash of the key. A lookup maps
+     *  the hash to its home slot and walks forward until it finds the key or an empty slot.
+     *  The load factor is kept at most 3/4, so the walk is short and usually stays in the
+     *  cache line of the home slot: one cache miss per lookup (plus the key's own indirections).
+     *
+     *  The stored hash is compared before the key, so colliding keys are rarely compared.
+     *  Erasure shifts the following entries back instead of leaving tombstones, so lookups
+     *  never slow down with churn.
+     *
+     *  Hashes are spread with a Fibonacci multiplier before indexing, so identity hashes
+     *  (`std::hash` of integers) still use the whole table.
+     *
+     *  @note Pointers to values are invalidated by any insertion or erasure.
+     */
+    template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+    class FlatHashMap {
+
+    private:
+
+        struct Slot {
+            using Entry = std::pair<Key, Value>;
+
+            Entry& entry() noexcept { return *std::launder(reinterpret_cast<Entry*>(storage)); }
+            const Entry& entry() const noexcept { return *std::launder(reinterpret_cast<const Entry*>(storage)); }
+
+            std::size_t hash;
+            bool used;
+            alignas(Entry) unsigned char storage[sizeof(Entry)];
+        };
+
+    public:
+
+        using key_type = Key;
+        using mapped_type = Value;
+
+        FlatHashMap() = default;
+
+        explicit FlatHashMap(std::size_t n, Hash hash = Hash(), KeyEqual equal = KeyEqual())
+            : hash_(std::move(hash)), equal_(std::move(equal))
+        {
+            reserve(n);
+        }
+
+        FlatHashMap(const FlatHashMap&) = delete;
+        FlatHashMap& operator=(const FlatHashMap&) = delete;
+
+        FlatHashMap(FlatHashMap&& other) noexcept
+            : hash_(std::move(other.hash_)), equal_(std::move(other.equal_)),
+              slots_(std::move(other.slots_)), capacity_(other.capacity_),
+              shift_(other.shift_), size_(other.size_)
+        {
+            other.capacity_ = 0;
+            other.size_ = 0;
+        }
+
+        FlatHashMap& operator=(FlatHashMap&& other) noexcept {
+            if (this != &other) {
+                clear();
+                hash_ = std::move(other.hash_);
+                equal_ = std::move(other.equal_);
+                slots_ = std::move(other.slots_);
+                capacity_ = std::exchange(other.capacity_, 0);
+                shift_ = other.shift_;
+                size_ = std::exchange(other.size_, 0);
+            }
+            return *this;
+        }
+
+        ~FlatHashMap() { clear(); }
+
+        /*! @brief Insert `Value(args...)` under `key` unless `key` is already present.
+         *  @return `false` if `key` was present, the map is then unchanged.
+         */
+        template <class... Args>
+        bool emplace(const Key& key, Args&&... args) {
+            const std::size_t hash = hash_(key);
+            if (find_slot(key, hash)) {
+                return false;
+            }
+            if ((size_ + 1) * 4 > capacity_ * 3) {
+                rehash(capacity_ ? capacity_ * 2 : min_capacity);
+            }
+            Slot& slot = slots_[free_slot(hash)];
+            ::new (static_cast<void*>(slot.storage)) typename Slot::Entry(
+                std::piecewise_construct,
+                std::forward_as_tuple(key),
+                std::forward_as_tuple(std::forward<Args>(args)...)
+            );
+            slot.hash = hash;
+            slot.used = true;
+            ++size_;
+            return true;
+        }
+
+        /*! @return `false` if `key` was not present.
+         */
+        bool erase(const Key& key) {
+            Slot* slot = find_slot(key, hash_(key));
+            if (!slot) {
+                return false;
+            }
+            slot->entry().~Entry();
+            slot->used = false;
+            --size_;
+            shift_back(static_cast<std::size_t>(slot - slots_.get()));
+            return true;
+        }
+
+        /*! @return The value under `key`, `nullptr` if there is none.
+         */
+        Value* find(const Key& key) noexcept {
+            Slot* slot = find_slot(key, hash_(key));
+            return slot ? &slot->entry().second : nullptr;
+        }
+
+        const Value* find(const Key& key) const noexcept {
+            return const_cast<FlatHashMap*>(this)->find(key);
+        }
+
+        bool contains(const Key& key) const noexcept { return find(key) != nullptr; }
+
+        /*! @brief Call `fun(key, value)` for every entry, in unspecified order.
+         */
+        template <class Fun>
+        void for_each(Fun&& fun) const {
+            for (std::size_t i = 0; i < capacity_; ++i) {
+                if (slots_[i].used) {
+                    const auto& entry = slots_[i].entry();
+                    fun(entry.first, entry.second);
+                }
+            }
+        }
+
+        /*! @brief Make room for `n` entries without rehashing.
+         */
+        void reserve(std::size_t n) {
+            std::size_t capacity = min_capacity;
+            while (n * 4 > capacity * 3) {
+                capacity *= 2;
+            }
+            if (capacity > capacity_) {
+                rehash(capacity);
+            }
+        }
+
+        void clear() noexcept {
+            for (std::size_t i = 0; i < capacity_ && size_; ++i) {
+                if (slots_[i].used) {
+                    slots_[i].entry().~Entry();
+                    slots_[i].used = false;
+                    --size_;
+                }
+            }
+        }
+
+        std::size_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+        std::size_t capacity() const noexcept { return capacity_; }
+
+    private:
+
+        using Entry = typename Slot::Entry;
+
+        static constexpr std::size_t min_capacity = 8;
+
+        std::size_t home(std::size_t hash) const noexcept {
+            // Fibonacci hashing: the high bits of the product depend on every bit of `hash`.
+            return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> shift_);
+        }
+
+        std::size_t next(std::size_t i) const noexcept { return (i + 1) & (capacity_ - 1); }
+
+        Slot* find_slot(const Key& key, std::size_t hash) const noexcept {
+            if (size_ == 0) {
+                return nullptr;
+            }
+            for (std::size_t i = home(hash); slots_[i].used; i = next(i)) {
+                if (slots_[i].hash == hash && equal_(slots_[i].entry().first, key)) {
+                    return &slots_[i];
+                }
+            }
+            return nullptr;
+        }
+
+        std::size_t free_slot(std::size_t hash) const noexcept {
+            std::size_t i = home(hash);
+            while (slots_[i].used) {
+                i = next(i);
+            }
+            return i;
+        }
+
+        // Move the entries following the emptied slot `hole` back, so that every entry
+        // stays reachable from its home slot without crossing an empty slot.
+        void shift_back(std::size_t hole) noexcept {
+            for (std::size_t i = next(hole); slots_[i].used; i = next(i)) {
+                const std::size_t ideal = home(slots_[i].hash);
+                // The entry may fill the hole unless its home lies cyclically in `(hole, i]`.
+                const bool reachable = hole <= i ? (ideal <= hole || ideal > i) : (ideal <= hole && ideal > i);
+                if (reachable) {
+                    relocate(slots_[i], slots_[hole]);
+                    hole = i;
+                }
+            }
+        }
+
+        static void relocate(Slot& from, Slot& to) noexcept {
+            static_assert(std::is_nothrow_move_constructible_v<Entry>, "`FlatHashMap` entries must be nothrow movable");
+            ::new (static_cast<void*>(to.storage)) Entry(std::move(from.entry()));
+            from.entry().~Entry();
+            to.hash = from.hash;
+            to.used = true;
+            from.used = false;
+        }
+
+        void rehash(std::size_t capacity) {
+            std::unique_ptr<Slot[]> old = std::exchange(slots_, std::make_unique<Slot[]>(capacity));   // Value initialized, all unused.
+            const std::size_t old_capacity = std::exchange(capacity_, capacity);
+            shift_ = 64;
+            for (std::size_t c = capacity; c > 1; c /= 2) {
+                --shift_;
+            }
+            for (std::size_t i = 0; i < old_capacity; ++i) {
+                if (old[i].used) {
+                    relocate(old[i], slots_[free_slot(old[i].hash)]);
+                }
+            }
+        }
+
+        Hash hash_;
+        KeyEqual equal_;
+        std::unique_ptr<Slot[]> slots_;
+        std::size_t capacity_ = 0;      // Zero or a power of two.
+        unsigned shift_ = 64;
+        std::size_t size_ = 0;
+
+    };
+
+} // end namespace `mosaic`
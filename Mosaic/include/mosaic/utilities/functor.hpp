@@ -6,7 +6,9 @@
 
 
 #include <memory>
+#include <memory_resource>
 #include <utility>
+#include "small_object.hpp"
 #include "type_traits.hpp"
 #if __cplusplus >= 202002L // Compiler supports C++20 standard and above.
     #include <concepts>
@@ -17,16 +19,30 @@ namespace mosaic {
     namespace fun_internal {
 
         /** @brief Abstract class defining interface for handlers for various callables.
+         *  @details Handlers are small and short lived, they are allocated through `SmallObject`
+         *  unless placed in a memory resource by `ResourceHandler`. Either way they are released
+         *  through `destroy()`.
          */
         template <typename RetT, typename... Params>
-        class FunctorImpl {
+        class FunctorImpl : public SmallObject<> {
         
         public:
+
+            struct Destroyer {
+                void operator()(FunctorImpl* p) const noexcept { p->destroy(); }
+            };
+
+            using Ptr = std::unique_ptr<FunctorImpl, Destroyer>;
+
             virtual RetT operator()(Params...) const = 0;
             virtual ~FunctorImpl() = default;
         
-            std::unique_ptr<FunctorImpl> clone() const {
-                return std::unique_ptr<FunctorImpl>(this->clone_impl());
+            Ptr clone() const {
+                return Ptr(this->clone_impl());
+            }
+
+            virtual void destroy() noexcept {
+                delete this;
             }
 
         private:
@@ -142,6 +158,47 @@ namespace mosaic {
 
         };
 
+
+        /** @brief Places a handler in a `std::pmr::memory_resource`, eg. a `MonotonicArena`.
+         *  @details Clones are placed in the same resource.
+         */
+        template <class Handler>
+        class ResourceHandler : public Handler {
+
+        public:
+
+            template <class... Args>
+            static ResourceHandler* create(std::pmr::memory_resource* resource, Args&&... args) {
+                void* p = resource->allocate(sizeof(ResourceHandler), alignof(ResourceHandler));
+                try {
+                    // `SmallObject` hides the global placement new.
+                    return ::new (p) ResourceHandler(resource, std::forward<Args>(args)...);
+                } catch (...) {
+                    resource->deallocate(p, sizeof(ResourceHandler), alignof(ResourceHandler));
+                    throw;
+                }
+            }
+
+            void destroy() noexcept override {
+                std::pmr::memory_resource* resource = resource_;
+                this->~ResourceHandler();
+                resource->deallocate(this, sizeof(ResourceHandler), alignof(ResourceHandler));
+            }
+
+        private:
+
+            template <class... Args>
+            ResourceHandler(std::pmr::memory_resource* resource, Args&&... args)
+                : Handler(std::forward<Args>(args)...), resource_(resource) {}
+
+            ResourceHandler* clone_impl() const override {
+                return create(resource_, static_cast<const Handler&>(*this));
+            }
+
+            std::pmr::memory_resource* resource_;
+
+        };
+
     } // end `fun_internal` namespace
 
 
@@ -152,7 +209,8 @@ namespace mosaic {
      *  - Allows delayed execution of callable entities.
      *  - Isolates the command object invoker from the request/callable itself.
      * 
-     * Works with different callable entities
+     * Works with different callable entities.
+     * Constructors taking `std::allocator_arg` place the callable in the given memory resource.
      */
     template <typename ReturnT, typename... Params>
     class Functor {
@@ -163,6 +221,17 @@ namespace mosaic {
         template <class Function> using FunctorHandler = fun_internal::FunctorHandler<Function, ReturnT, Params...>;
         template <class Fun> using FunctionHandler = fun_internal::FunctionHandler<Fun, ReturnT, Params...>;
         template <class ObjPointer, class MemFunPointer> using MemFunHandler = fun_internal::MemFunHandler<ObjPointer, MemFunPointer, ReturnT, Params...>;
+        using ImplPtr = typename FunImpl::Ptr;
+
+        template <class Handler, class... Args>
+        static ImplPtr make_impl(Args&&... args) {
+            return ImplPtr(new Handler(std::forward<Args>(args)...));
+        }
+
+        template <class Handler, class... Args>
+        static ImplPtr make_impl_in(std::pmr::memory_resource* resource, Args&&... args) {
+            return ImplPtr(fun_internal::ResourceHandler<Handler>::create(resource, std::forward<Args>(args)...));
+        }
     
     public:
 
@@ -171,13 +240,15 @@ namespace mosaic {
         
         Functor() = default;
 
-        explicit Functor(std::unique_ptr<FunImpl> upImpl): upImpl_(std::move(upImpl)) {}
+        explicit Functor(std::unique_ptr<FunImpl> upImpl): upImpl_(upImpl.release()) {}
+
+        explicit Functor(ImplPtr upImpl): upImpl_(std::move(upImpl)) {}
 
         // Accept other functor objects
         template <class Fun>
         Functor(Fun&& fun): 
             upImpl_(
-                std::make_unique<
+                make_impl<
                     FunctorHandler<typename TypeTraits<Fun>::ReferredType>
                 >(std::forward<Fun>(fun))
             ) {}
@@ -186,7 +257,7 @@ namespace mosaic {
         template <typename FRetT, typename... FParams>
         Functor(FRetT (&fun)(FParams ...))
         : upImpl_(
-                std::make_unique<
+                make_impl<
                     FunctionHandler<FRetT(&)(FParams...)>
                 >(fun)
             ) 
@@ -200,10 +271,32 @@ namespace mosaic {
         template<class ObjPointer, class MemFunPointer>
         Functor(ObjPointer p_obj, MemFunPointer p_mem_fun ): 
             upImpl_(
-                std::make_unique<
+                make_impl<
                     MemFunHandler<ObjPointer, MemFunPointer>
                 >(p_obj, p_mem_fun)
             ) {}
+
+        // Accept functor objects, placed in `resource`
+        template <class Fun>
+        Functor(std::allocator_arg_t, std::pmr::memory_resource* resource, Fun&& fun):
+            upImpl_(
+                make_impl_in<
+                    FunctorHandler<typename TypeTraits<Fun>::ReferredType>
+                >(resource, std::forward<Fun>(fun))
+            ) {}
+
+        // Accept functions, placed in `resource`
+        template <typename FRetT, typename... FParams>
+        Functor(std::allocator_arg_t, std::pmr::memory_resource* resource, FRetT (&fun)(FParams ...))
+        : upImpl_(
+                make_impl_in<
+                    FunctionHandler<FRetT(&)(FParams...)>
+                >(resource, fun)
+            ) 
+        {
+            static_assert((Conversion<FParams, Params>::exists && ...), "One or more parameter types are not convertible!");
+            static_assert(Conversion<FRetT, ReturnT>::exists, "Return type is not convertible!"); 
+        }
         
         // ------------
 
@@ -238,15 +331,14 @@ namespace mosaic {
             return (*upImpl_)(static_cast<Params>(params) ...);
         }
 
-        // Clone member function
+        // Clone member function, the clone lives in the same memory resource
         Functor clone() const {
-            std::unique_ptr<FunImpl> u_ptr = upImpl_->clone();
-            return Functor(std::move(u_ptr));
+            return Functor(upImpl_->clone());
         }
 
     private:
 
-        std::unique_ptr<FunImpl> upImpl_;
+        ImplPtr upImpl_;
 
     };
 
@@ -316,13 +408,35 @@ namespace mosaic {
         using OutFunctor = Functor<RetT, UnboundParamsT...>;
         using OutFuncImpl = fun_internal::FunctorImpl<RetT, UnboundParamsT...>;
      
-        std::unique_ptr<OutFuncImpl> u_ptr = 
-            std::make_unique<fun_internal::BinderFirst<InFunctor>>(fun, bound);
+        typename OutFuncImpl::Ptr u_ptr(new fun_internal::BinderFirst<InFunctor>(fun, bound));
      
         return OutFunctor(std::move(u_ptr));
 
     }
 
+    /** @brief Helper function to bind first argument of a `Functor`, placing the binder in `resource`
+     *  @sa Functor
+     */
+    template <typename RetT, typename BoundParamT, typename... UnboundParamsT>
+    Functor<RetT, UnboundParamsT...>
+    BindFirst(
+        std::allocator_arg_t, std::pmr::memory_resource* resource,
+        const Functor<RetT, BoundParamT, UnboundParamsT...>& fun,
+        BoundParamT bound) 
+    {
+
+        using InFunctor = Functor<RetT, BoundParamT, UnboundParamsT...>;
+        using OutFunctor = Functor<RetT, UnboundParamsT...>;
+        using OutFuncImpl = fun_internal::FunctorImpl<RetT, UnboundParamsT...>;
+
+        typename OutFuncImpl::Ptr u_ptr(
+            fun_internal::ResourceHandler<fun_internal::BinderFirst<InFunctor>>::create(resource, fun, bound)
+        );
+
+        return OutFunctor(std::move(u_ptr));
+
+    }
+
     /**************************************************/
 
 } // end namespace `mosaic`
\ No newline at end of file
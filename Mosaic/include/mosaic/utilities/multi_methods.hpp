@@ -0,0 +1,320 @@
+#pragma once
+
+/*! @file multi_methods.hpp
+ *  @brief Provides double dispatch, calling a function selected by the dynamic types of two objects.
+ *  @details Three dispatchers, from the most static to the fastest:
+ *      - `StaticDispatcher`, a `dynamic_cast` chain generated from two typelists, into the
+ *        overloads of an executor. Type safe and complete at compile time, linear in the number of types.
+ *      - `BasicDispatcher`, a hash map from the pair of `TypeInfo`s (or `TypeId`s) to a callback, filled at runtime.
+ *      - `FnDispatcher`, a 2D table of function pointers indexed by the dense type indices of
+ *        `DenseVisitableBase` hierarchies: two loads and one indirect call, whatever the number of types.
+ */
+
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "flat_hash_map.hpp"
+#include "type_id.hpp"
+#include "typelist.hpp"
+
+
+namespace mosaic {
+
+    namespace policies {
+
+        /*! @brief Default error policy of `BasicDispatcher` and `FnDispatcher`, throws `Exception`
+         *  when no callback is registered for the dynamic types of the arguments.
+         *
+         *  @details An error policy provides `static ResultType OnUnknownTypes(BaseLhs&, BaseRhs&)`,
+         *  whose result is returned by `Go()`. It may also return a default result.
+         */
+        template <class BaseLhs, class BaseRhs, typename ResultType>
+        struct DefaultDispatcherError {
+
+            class Exception : public std::exception {
+            public:
+                const char* what() const noexcept override { return "No callback registered for the dynamic types passed to Dispatcher"; }
+            };
+
+            static ResultType OnUnknownTypes(BaseLhs&, BaseRhs&) {
+                throw Exception();
+            }
+
+        };
+
+    } // end namespace `policies`
+
+    /**************************************************/
+
+    /*! @brief Double dispatch through `dynamic_cast`s over the types of two typelists.
+     *
+     *  @details `Go(lhs, rhs, exec)` finds the dynamic types of `lhs` in `TypesLhs` and of `rhs`
+     *  in `TypesRhs`, then calls `exec.Fire(concrete_lhs, concrete_rhs)`. The typelists are sorted
+     *  with `DerivedToFront`, so an object is matched to its most derived type of the list.
+     *  An object of none of the types calls `exec.OnError(lhs, rhs)` instead.
+     *
+     *  When `symmetric`, the arguments are swapped if the type of `rhs` comes first in the
+     *  typelists, so the executor only implements `Fire(A&, B&)` with `A` before `B`.
+     *
+     *  @code
+     *  struct Collide {
+     *      void Fire(Asteroid&, Asteroid&);
+     *      void Fire(Asteroid&, Ship&);
+     *      void Fire(Ship&, Ship&);
+     *      void OnError(Body&, Body&);
+     *  };
+     *  using Dispatcher = StaticDispatcher<Collide, Body, MakeTL<Asteroid, Ship>::TL>;
+     *  Dispatcher::Go(ship, asteroid, collide);     // Calls `collide.Fire(asteroid, ship)`.
+     *  @endcode
+     *
+     *  @note Every pair of types instantiates a call to `Fire()`, so the executor must handle all of them.
+     */
+    template <
+        class Executor,
+        class BaseLhs,
+        class TypesLhs,
+        bool symmetric = true,
+        class BaseRhs = BaseLhs,
+        class TypesRhs = TypesLhs,
+        typename ResultType = void
+    >
+    class StaticDispatcher {
+
+    public:
+
+        static ResultType Go(BaseLhs& lhs, BaseRhs& rhs, Executor& exec) {
+            return dispatch_lhs<typename tl::DerivedToFront<TypesLhs>::Result>(lhs, rhs, exec);
+        }
+
+    private:
+
+        template <class TList>
+        static ResultType dispatch_lhs(BaseLhs& lhs, BaseRhs& rhs, Executor& exec) {
+            if constexpr (std::is_same_v<TList, NullType>) {
+                return exec.OnError(lhs, rhs);
+            } else {
+                using Head = typename TList::Head;
+                if (Head* p = dynamic_cast<Head*>(&lhs)) {
+                    return dispatch_rhs<typename tl::DerivedToFront<TypesRhs>::Result>(*p, rhs, exec);
+                }
+                return dispatch_lhs<typename TList::Tail>(lhs, rhs, exec);
+            }
+        }
+
+        template <class TList, class SomeLhs>
+        static ResultType dispatch_rhs(SomeLhs& lhs, BaseRhs& rhs, Executor& exec) {
+            if constexpr (std::is_same_v<TList, NullType>) {
+                return exec.OnError(lhs, rhs);
+            } else {
+                using Head = typename TList::Head;
+                if (Head* p = dynamic_cast<Head*>(&rhs)) {
+                    return fire(lhs, *p, exec);
+                }
+                return dispatch_rhs<typename TList::Tail>(lhs, rhs, exec);
+            }
+        }
+
+        template <class SomeLhs, class SomeRhs>
+        static ResultType fire(SomeLhs& lhs, SomeRhs& rhs, Executor& exec) {
+            constexpr bool swap_args = symmetric
+                && int(tl::IndexOf<TypesRhs, SomeRhs>::value) < int(tl::IndexOf<TypesLhs, SomeLhs>::value);
+            if constexpr (swap_args) {
+                return exec.Fire(rhs, lhs);
+            } else {
+                return exec.Fire(lhs, rhs);
+            }
+        }
+
+    };
+
+    /**************************************************/
+
+    namespace multi_methods_internal {
+
+        template <typename KeyType>
+        struct KeyPairHash {
+            std::size_t operator()(const std::pair<KeyType, KeyType>& key) const noexcept {
+                const std::size_t lhs = std::hash<KeyType>()(key.first);
+                return lhs ^ (std::hash<KeyType>()(key.second) + 0x9E3779B97F4A7C15ull + (lhs << 6) + (lhs >> 2));
+            }
+        };
+
+        // Signature of a callback taking concrete types.
+        template <class Callback>
+        struct CallbackTraits;
+
+        template <typename R, class SomeLhs, class SomeRhs>
+        struct CallbackTraits<R (*)(SomeLhs&, SomeRhs&)> {
+            using Lhs = SomeLhs;
+            using Rhs = SomeRhs;
+        };
+
+    } // end `multi_methods_internal` namespace
+
+
+    /*! @brief Double dispatch through a hash map from the dynamic types of the arguments to a callback.
+     *
+     *  @details Callbacks are registered at runtime for pairs of exact dynamic types, and receive
+     *  the arguments as their base classes. A derived type without its own registration is unknown.
+     *
+     *  @tparam CallbackType Called as `ResultType(BaseLhs&, BaseRhs&)`, eg. a function pointer or a `Functor`.
+     *  @tparam TypeKey Type key policy, `policies::TypeInfoKey` by default, `policies::TypeIdKey` without RTTI.
+     */
+    template <
+        class BaseLhs,
+        class BaseRhs = BaseLhs,
+        typename ResultType = void,
+        class CallbackType = ResultType (*)(BaseLhs&, BaseRhs&),
+        class ErrorPolicy = policies::DefaultDispatcherError<BaseLhs, BaseRhs, ResultType>,
+        class TypeKey = policies::DefaultTypeKey
+    >
+    class BasicDispatcher {
+
+    public:
+
+        using KeyType = typename TypeKey::KeyType;
+
+        /*! @brief Register `fun` for `SomeLhs` and `SomeRhs`, replacing any previous callback.
+         */
+        template <class SomeLhs, class SomeRhs>
+        void Add(CallbackType fun) {
+            Add(TypeKey::template OfType<SomeLhs>(), TypeKey::template OfType<SomeRhs>(), std::move(fun));
+        }
+
+        void Add(const KeyType& lhs, const KeyType& rhs, CallbackType fun) {
+            const Key key(lhs, rhs);
+            if (CallbackType* registered = callbacks_.find(key)) {
+                *registered = std::move(fun);
+            } else {
+                callbacks_.emplace(key, std::move(fun));
+            }
+        }
+
+        /*! @return `false` if no callback was registered for `SomeLhs` and `SomeRhs`.
+         */
+        template <class SomeLhs, class SomeRhs>
+        bool Remove() {
+            return Remove(TypeKey::template OfType<SomeLhs>(), TypeKey::template OfType<SomeRhs>());
+        }
+
+        bool Remove(const KeyType& lhs, const KeyType& rhs) {
+            return callbacks_.erase(Key(lhs, rhs));
+        }
+
+        /*! @brief Call the callback registered for the dynamic types of `lhs` and `rhs`.
+         */
+        ResultType Go(BaseLhs& lhs, BaseRhs& rhs) {
+            CallbackType* fun = callbacks_.find(Key(TypeKey::OfObject(lhs), TypeKey::OfObject(rhs)));
+            if (!fun) {
+                return ErrorPolicy::OnUnknownTypes(lhs, rhs);
+            }
+            return (*fun)(lhs, rhs);
+        }
+
+    private:
+
+        using Key = std::pair<KeyType, KeyType>;
+
+        FlatHashMap<Key, CallbackType, multi_methods_internal::KeyPairHash<KeyType>> callbacks_;
+
+    };
+
+    /**************************************************/
+
+    /*! @brief Double dispatch through a 2D table of function pointers, indexed by the
+     *  `DenseVisitableBase` type indices of the arguments.
+     *
+     *  @details `Go(lhs, rhs)` loads both type indices and calls the function pointer at their
+     *  intersection, with no branch and no search. Unregistered pairs hold `ErrorPolicy::OnUnknownTypes`.
+     *
+     *  Callbacks are plain functions taking the concrete types, registered as template arguments,
+     *  so the table entries are trampolines that `static_cast` the arguments and inline the callback.
+     *  With `symmetric`, one registration serves both argument orders.
+     *
+     *  @code
+     *  void collide(Asteroid&, Ship&);
+     *  FnDispatcher<Body> dispatcher;
+     *  dispatcher.Add<&collide, true>();
+     *  dispatcher.Go(ship, asteroid);      // Calls `collide(asteroid, ship)`.
+     *  @endcode
+     *
+     *  @tparam BaseLhs, BaseRhs Classes deriving from `DenseVisitableBase`. Types are matched exactly
+     *  by their index: a callback for a class does not apply to the classes deriving from it.
+     */
+    template <
+        class BaseLhs,
+        class BaseRhs = BaseLhs,
+        typename ResultType = void,
+        class ErrorPolicy = policies::DefaultDispatcherError<BaseLhs, BaseRhs, ResultType>
+    >
+    class FnDispatcher {
+
+    public:
+
+        using LhsList = typename BaseLhs::VisitableList;
+        using RhsList = typename BaseRhs::VisitableList;
+        using CallbackType = ResultType (*)(BaseLhs&, BaseRhs&);
+
+        static constexpr std::size_t n_lhs = tl::Length<LhsList>::value;
+        static constexpr std::size_t n_rhs = tl::Length<RhsList>::value;
+
+        FnDispatcher() : table_(n_lhs * n_rhs, &ErrorPolicy::OnUnknownTypes) {}
+
+        /*! @brief Register `callback`, a function `ResultType(SomeLhs&, SomeRhs&)`, for its parameter types.
+         *  @details With `symmetric`, also for the swapped types, calling `callback` with the arguments swapped.
+         */
+        template <auto callback, bool symmetric = false>
+        void Add() {
+            using Traits = multi_methods_internal::CallbackTraits<decltype(callback)>;
+            using SomeLhs = typename Traits::Lhs;
+            using SomeRhs = typename Traits::Rhs;
+            at<SomeLhs, SomeRhs>() = &trampoline<SomeLhs, SomeRhs, callback>;
+            if constexpr (symmetric) {
+                static_assert(std::is_same_v<BaseLhs, BaseRhs>, "Symmetric callbacks need both arguments in the same hierarchy!");
+                at<SomeRhs, SomeLhs>() = &swapped_trampoline<SomeLhs, SomeRhs, callback>;
+            }
+        }
+
+        /*! @brief Unregister the callback of `SomeLhs` and `SomeRhs` (and of the swapped types with `symmetric`).
+         */
+        template <class SomeLhs, class SomeRhs, bool symmetric = false>
+        void Remove() {
+            at<SomeLhs, SomeRhs>() = &ErrorPolicy::OnUnknownTypes;
+            if constexpr (symmetric) {
+                at<SomeRhs, SomeLhs>() = &ErrorPolicy::OnUnknownTypes;
+            }
+        }
+
+        ResultType Go(BaseLhs& lhs, BaseRhs& rhs) const {
+            return table_[lhs.type_index() * n_rhs + rhs.type_index()](lhs, rhs);
+        }
+
+    private:
+
+        template <class SomeLhs, class SomeRhs>
+        CallbackType& at() noexcept {
+            constexpr int lhs = tl::IndexOf<LhsList, std::remove_const_t<SomeLhs>>::value;
+            constexpr int rhs = tl::IndexOf<RhsList, std::remove_const_t<SomeRhs>>::value;
+            static_assert(lhs != -1 && rhs != -1, "Type is not in the visitable typelist!");
+            return table_[static_cast<std::size_t>(lhs) * n_rhs + static_cast<std::size_t>(rhs)];
+        }
+
+        template <class SomeLhs, class SomeRhs, auto callback>
+        static ResultType trampoline(BaseLhs& lhs, BaseRhs& rhs) {
+            return callback(static_cast<SomeLhs&>(lhs), static_cast<SomeRhs&>(rhs));
+        }
+
+        template <class SomeLhs, class SomeRhs, auto callback>
+        static ResultType swapped_trampoline(BaseLhs& lhs, BaseRhs& rhs) {
+            return callback(static_cast<SomeLhs&>(rhs), static_cast<SomeRhs&>(lhs));
+        }
+
+        std::vector<CallbackType> table_;     // Row major, one row per type of `LhsList`.
+
+    };
+
+} // end namespace `mosaic`
@@ -0,0 +1,214 @@
+#pragma once
+
+/*! @file object_pool.hpp
+ *  @brief Provides `ObjectPool`, recycling objects of one type through a free list over contiguous slabs.
+ */
+
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "allocator_stats.hpp"
+
+
+namespace mosaic {
+
+    /*! @brief Default reset hook of `ObjectPool`, released objects are destroyed.
+     */
+    struct DestroyOnRelease {};
+
+
+    /*! @brief Pool of `T` objects handed out as `unique_ptr`s that return them to the pool.
+     *
+     *  @details Objects live in slabs of `objects_per_slab` contiguous slots taken from an
+     *  upstream `std::pmr::memory_resource`. Released slots go on a LIFO free list, so the most
+     *  recently released (cache warm) object is reused first.
+     *
+     *  With a `Reset` hook other than `DestroyOnRelease`, released objects are not destroyed but
+     *  passed to `reset(T&)` and kept constructed, so they keep their internal buffers.
+     *  `acquire()` then hands them out again as they are, its arguments are only used to
+     *  construct objects when no released one is available.
+     *
+     *  @tparam Reset `DestroyOnRelease`, or a callable `void(T&)` run on every released object.
+     *
+     *  @note Not thread safe. The pool must outlive its handles.
+     */
+    template <class T, class Reset = DestroyOnRelease>
+    class ObjectPool {
+
+    private:
+
+        static constexpr bool keeps_objects = !std::is_same_v<Reset, DestroyOnRelease>;
+
+        // Storage first, so that a `T*` converts back to its slot.
+        struct Slot {
+            alignas(T) unsigned char storage[sizeof(T)];
+            Slot* next;
+        };
+
+    public:
+
+        class Recycler {
+        public:
+            Recycler() noexcept = default;
+            explicit Recycler(ObjectPool* pool) noexcept : pool_(pool) {}
+            void operator()(T* p) const noexcept { pool_->release(p); }
+        private:
+            ObjectPool* pool_ = nullptr;
+        };
+
+        using Handle = std::unique_ptr<T, Recycler>;
+
+        explicit ObjectPool(
+            std::size_t objects_per_slab = 64,
+            std::pmr::memory_resource* upstream = std::pmr::get_default_resource()
+        )
+            : ObjectPool(Reset{}, objects_per_slab, upstream)
+        {
+        }
+
+        explicit ObjectPool(
+            Reset reset,
+            std::size_t objects_per_slab = 64,
+            std::pmr::memory_resource* upstream = std::pmr::get_default_resource()
+        )
+            : reset_(std::move(reset)),
+              objects_per_slab_(objects_per_slab ? objects_per_slab : 1),
+              upstream_(upstream)
+        {
+        }
+
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool& operator=(const ObjectPool&) = delete;
+
+        ~ObjectPool() {
+            assert(in_use_ == 0 && "`ObjectPool` destroyed while handles are alive");
+            if constexpr (keeps_objects) {
+                for (Slot* slot = free_list_; slot; slot = slot->next) {
+                    object(slot)->~T();
+                }
+            }
+            for (Slot* slab : slabs_) {
+                upstream_->deallocate(slab, objects_per_slab_ * sizeof(Slot), alignof(Slot));
+            }
+        }
+
+        /*! @brief A released object if there is one, otherwise a new `T(args...)`.
+         */
+        template <class... Args>
+        Handle acquire(Args&&... args) {
+            if (free_list_) {
+                Slot* slot = free_list_;
+                free_list_ = slot->next;
+                --n_free_;
+                if constexpr (keeps_objects) {
+                    on_acquire();
+                    return Handle(object(slot), Recycler(this));
+                }
+                return construct(slot, std::forward<Args>(args)...);
+            }
+            return construct(carve(), std::forward<Args>(args)...);
+        }
+
+        std::size_t in_use() const noexcept { return in_use_; }
+        std::size_t available() const noexcept { return n_free_; }
+        std::size_t slab_count() const noexcept { return slabs_.size(); }
+        std::size_t capacity() const noexcept { return slabs_.size() * objects_per_slab_; }
+
+        AllocatorStats stats() const {
+            AllocatorStats stats;
+            stats.bytes_in_use = in_use_ * sizeof(T);
+            stats.peak_bytes = peak_in_use_ * sizeof(T);
+            stats.bytes_reserved = capacity() * sizeof(Slot);
+            stats.slab_count = slabs_.size();
+            stats.allocations = acquisitions_;
+            stats.size_classes.push_back({sizeof(T), acquisitions_, in_use_});
+            return stats;
+        }
+
+    private:
+
+        static T* object(Slot* slot) noexcept {
+            return std::launder(reinterpret_cast<T*>(slot->storage));
+        }
+
+        static Slot* slot_of(T* p) noexcept {
+            return reinterpret_cast<Slot*>(p);
+        }
+
+        void on_acquire() noexcept {
+            ++acquisitions_;
+            if (++in_use_ > peak_in_use_) {
+                peak_in_use_ = in_use_;
+            }
+        }
+
+        template <class... Args>
+        Handle construct(Slot* slot, Args&&... args) {
+            T* p;
+            try {
+                p = ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                if constexpr (keeps_objects) {
+                    --carve_ptr_;   // Only fresh slots are constructed, the free list holds objects.
+                } else {
+                    push(slot);
+                }
+                throw;
+            }
+            on_acquire();
+            return Handle(p, Recycler(this));
+        }
+
+        Slot* carve() {
+            if (carve_ptr_ == carve_end_) {
+                if (slabs_.size() == slabs_.capacity()) {
+                    slabs_.reserve(std::max<std::size_t>(2 * slabs_.size(), 8));   // Grow before allocating, to keep the new slab if this throws.
+                }
+                Slot* slab = static_cast<Slot*>(upstream_->allocate(objects_per_slab_ * sizeof(Slot), alignof(Slot)));
+                slabs_.push_back(slab);
+                carve_ptr_ = slab;
+                carve_end_ = slab + objects_per_slab_;
+            }
+            return carve_ptr_++;
+        }
+
+        void push(Slot* slot) noexcept {
+            slot->next = free_list_;
+            free_list_ = slot;
+            ++n_free_;
+        }
+
+        void release(T* p) noexcept {
+            if constexpr (keeps_objects) {
+                reset_(*p);
+            } else {
+                p->~T();
+            }
+            --in_use_;
+            push(slot_of(p));
+        }
+
+        Reset reset_;
+        std::size_t objects_per_slab_;
+        std::pmr::memory_resource* upstream_;
+
+        Slot* free_list_ = nullptr;     // Constructed objects iff `keeps_objects`.
+        std::size_t n_free_ = 0;
+        std::size_t in_use_ = 0;
+        std::size_t peak_in_use_ = 0;
+        std::size_t acquisitions_ = 0;
+
+        Slot* carve_ptr_ = nullptr;     // Never used slots of the newest slab.
+        Slot* carve_end_ = nullptr;
+        std::vector<Slot*> slabs_;
+
+    };
+
+} // end namespace `mosaic`
@@ -0,0 +1,166 @@
+#pragma once
+
+/*! @file parallel_visitor.hpp
+ *  @brief Provides `ParallelVisitAll()`, visiting the objects of a collection on a `ThreadPool`.
+ *  @details The collection is split into chunks, each visited by its own copy of the visitor.
+ *  Visitors accumulate their results in their own members, kept on separate cache lines, so
+ *  workers share nothing while they run, and a user supplied `merge` combines the copies once
+ *  every chunk is done.
+ *
+ *  @code
+ *  struct TotalArea {
+ *      void Visit(Circle& c) { area += c.area(); }
+ *      void Visit(Square& s) { area += s.area(); }
+ *      double area = 0.0;
+ *  };
+ *  TotalArea total = ParallelVisitAll(pool, shapes, TotalArea(), [](TotalArea& into, const TotalArea& part) {
+ *      into.area += part.area;
+ *  });
+ *  @endcode
+ */
+
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "thread_pool.hpp"
+#include "visitor.hpp"
+
+
+namespace mosaic {
+
+    namespace parallel_visitor_internal {
+
+        template <class VisitorT, class Node, class = void>
+        struct HasAccept : std::false_type {};
+
+        template <class VisitorT, class Node>
+        struct HasAccept<VisitorT, Node, std::void_t<decltype(std::declval<Node&>().Accept(std::declval<VisitorT&>()))>>
+            : std::true_type {};
+
+        // Visitor copy on cache lines of its own, workers accumulating into neighbouring copies
+        // would otherwise keep stealing the line from each other.
+        template <class VisitorT>
+        struct alignas(std::max<std::size_t>(64, alignof(VisitorT))) Part {
+            VisitorT visitor;
+        };
+
+        template <class Iterator>
+        struct Chunk {
+            Iterator begin() const { return first; }
+            Iterator end() const { return last; }
+            Iterator first;
+            Iterator last;
+        };
+
+        // Objects with an `Accept()` for the visitor, eg. `CyclicVisitor` visitables, accept it,
+        // `DenseVisitableBase` hierarchies go through `VisitAll()`.
+        template <class VisitorT, class Iterator>
+        void visit_chunk(VisitorT& visitor, Iterator first, Iterator last) {
+            using Node = std::remove_reference_t<decltype(**first)>;
+            if constexpr (HasAccept<VisitorT, Node>::value) {
+                for (; first != last; ++first) {
+                    (**first).Accept(visitor);
+                }
+            } else {
+                VisitAll(Chunk<Iterator>{first, last}, visitor);
+            }
+        }
+
+    } // end `parallel_visitor_internal` namespace
+
+
+    /*! @brief Visit every element of `range` with copies of `visitor` running on `pool`, and merge the copies.
+     *
+     *  @details `range` is split into chunks of contiguous elements. Each chunk is visited by a copy
+     *  of `visitor`, with `Accept()` if the objects have one for it, with `VisitAll()` otherwise (so
+     *  `VisitorT::visit_order` applies within a chunk). The calling thread visits the first chunk
+     *  itself, then `merge(result, part)` folds the other copies into the first one, in the order of
+     *  their chunks, so a deterministic merge gives a deterministic result.
+     *
+     *  If a chunk throws, the first exception is rethrown once every chunk has finished. So is an
+     *  exception thrown while submitting the chunks, eg. by `pool` or by copying iterators.
+     *
+     *  @param range Random access range of pointers (or smart pointers) to the visited objects.
+     *  It must not be modified until the call returns.
+     *  @param merge Callable `void(VisitorT& result, VisitorT& part)`.
+     *  @param n_chunks Maximum number of chunks, `0` selects four per worker, for load balancing.
+     *  @return The merged visitor, a copy of `visitor` if `range` is empty.
+     *
+     *  @note Must not be called from a task of `pool`: waiting for the chunks would hold a worker they may need.
+     */
+    template <class Range, class VisitorT, class Merge>
+    VisitorT ParallelVisitAll(ThreadPool& pool, Range&& range, const VisitorT& visitor, Merge merge, std::size_t n_chunks = 0) {
+
+        using Iterator = decltype(std::begin(range));
+        static_assert(
+            std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>,
+            "ParallelVisitAll() needs a random access range!"
+        );
+
+        const Iterator first = std::begin(range);
+        const std::size_t size = static_cast<std::size_t>(std::end(range) - first);
+        if (n_chunks == 0) {
+            n_chunks = 4 * pool.size();
+        }
+        n_chunks = std::max<std::size_t>(1, std::min(n_chunks, size));
+        const std::size_t chunk_size = (size + n_chunks - 1) / n_chunks;
+
+        // Rounding the chunk size up may leave fewer chunks than requested.
+        if (size > 0) {
+            n_chunks = (size + chunk_size - 1) / chunk_size;
+        }
+
+        // Copies are made on the calling thread, `visitor` need not be thread safe.
+        using Part = parallel_visitor_internal::Part<VisitorT>;
+        std::vector<Part> parts(n_chunks, Part{visitor});
+        std::vector<std::future<void>> done;
+        done.reserve(n_chunks - 1);
+        try {
+            for (std::size_t i = 1; i < n_chunks; ++i) {
+                const Iterator chunk_first = first + static_cast<std::ptrdiff_t>(i * chunk_size);
+                const Iterator chunk_last = first + static_cast<std::ptrdiff_t>(std::min(size, (i + 1) * chunk_size));
+                VisitorT* part = &parts[i].visitor;
+                done.push_back(pool.submit([part, chunk_first, chunk_last]() {
+                    parallel_visitor_internal::visit_chunk(*part, chunk_first, chunk_last);
+                }));
+            }
+        } catch (...) {
+            // The chunks already submitted still visit into `parts`.
+            for (std::future<void>& chunk : done) {
+                chunk.wait();
+            }
+            throw;
+        }
+
+        std::exception_ptr error;
+        try {
+            parallel_visitor_internal::visit_chunk(parts[0].visitor, first, first + static_cast<std::ptrdiff_t>(std::min(size, chunk_size)));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        for (std::future<void>& chunk : done) {
+            try {
+                chunk.get();
+            } catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        for (std::size_t i = 1; i < n_chunks; ++i) {
+            merge(parts[0].visitor, parts[i].visitor);
+        }
+        return std::move(parts[0].visitor);
+    }
+
+} // end namespace `mosaic`
@@ -0,0 +1,129 @@
+#pragma once
+
+/*! @file rcu.hpp
+ *  @brief Provides `RcuCell`, publishing immutable snapshots to wait-free readers (read-copy-update).
+ */
+
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+
+namespace mosaic {
+
+    namespace rcu_internal {
+
+        constexpr std::size_t n_stripes = 16;
+
+        // Threads are spread round robin over the reader counters.
+        inline std::size_t reader_stripe() noexcept {
+            static std::atomic<std::size_t> next{0};
+            thread_local const std::size_t stripe = next.fetch_add(1, std::memory_order_relaxed) % n_stripes;
+            return stripe;
+        }
+
+    } // end `rcu_internal` namespace
+
+
+    /*! @brief Holds an immutable `T` that readers use without locks while writers replace it.
+     *
+     *  @details `read(fun)` runs `fun(const T&)` on the current snapshot. It increments a reader
+     *  counter, loads the snapshot pointer and decrements the counter when `fun` returns: no loop,
+     *  no lock, so readers are wait-free and never wait for writers. The counters are striped over
+     *  cache lines, so readers on different cores rarely share one.
+     *
+     *  `update(fun)` builds the next snapshot from the current one, publishes it, then waits for a
+     *  grace period before deleting the previous one. The counters come in two epochs. New readers
+     *  enter the current epoch, so the writer flips it and waits for the readers of the other epoch
+     *  to leave, twice, which covers the readers that loaded the epoch just before a flip.
+     *  Writers are serialized by a mutex and pay the copy and the wait.
+     *
+     *  @note Suited to data read continuously and updated rarely, eg. registries filled by plugins.
+     *  A reader must not call `update()` on the same cell, it would wait for itself.
+     */
+    template <class T>
+    class RcuCell {
+
+    public:
+
+        explicit RcuCell(std::unique_ptr<T> initial = std::make_unique<T>())
+            : current_(initial.release())
+        {
+        }
+
+        RcuCell(const RcuCell&) = delete;
+        RcuCell& operator=(const RcuCell&) = delete;
+
+        ~RcuCell() { delete current_.load(std::memory_order_relaxed); }
+
+        /*! @brief `fun(snapshot)`, with the snapshot kept alive until `fun` returns.
+         */
+        template <class Fun>
+        decltype(auto) read(Fun&& fun) const {
+            ReadSection section(*this);
+            return std::forward<Fun>(fun)(*current_.load(std::memory_order_seq_cst));
+        }
+
+        /*! @brief Replace the snapshot by `fun(snapshot)`, unless it returns `nullptr`.
+         *  @details Returns once no reader can still see the previous snapshot, which is then deleted.
+         *  @param fun Callable `std::unique_ptr<T>(const T&)`.
+         */
+        template <class Fun>
+        void update(Fun&& fun) {
+            std::lock_guard<std::mutex> lock(writer_);
+            std::unique_ptr<T> next = std::forward<Fun>(fun)(*current_.load(std::memory_order_relaxed));
+            if (!next) {
+                return;
+            }
+            std::unique_ptr<T> previous(current_.exchange(next.release(), std::memory_order_seq_cst));
+            synchronize();
+        }
+
+    private:
+
+        struct alignas(64) Counter {
+            std::atomic<std::size_t> readers{0};
+        };
+
+        using Epoch = std::array<Counter, rcu_internal::n_stripes>;
+
+        class ReadSection {
+        public:
+            explicit ReadSection(const RcuCell& cell) noexcept
+                : counter_(cell.epochs_[cell.epoch_.load(std::memory_order_seq_cst) & 1][rcu_internal::reader_stripe()].readers)
+            {
+                // Sequentially consistent, so that the snapshot is loaded after the increment is visible.
+                counter_.fetch_add(1, std::memory_order_seq_cst);
+            }
+            ~ReadSection() { counter_.fetch_sub(1, std::memory_order_release); }
+            ReadSection(const ReadSection&) = delete;
+            ReadSection& operator=(const ReadSection&) = delete;
+        private:
+            std::atomic<std::size_t>& counter_;
+        };
+
+        // Wait until every reader that may have loaded the previous snapshot has left.
+        void synchronize() {
+            for (int flip = 0; flip < 2; ++flip) {
+                const unsigned old_epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) & 1;
+                for (Counter& counter : epochs_[old_epoch]) {
+                    while (counter.readers.load(std::memory_order_seq_cst) != 0) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+
+        mutable std::array<Epoch, 2> epochs_;
+        std::atomic<unsigned> epoch_{0};
+        std::atomic<T*> current_;
+        std::mutex writer_;
+
+    };
+
+} // end namespace `mosaic`
@@ -0,0 +1,309 @@
+#pragma once
+
+/*! @file shared_memory.hpp
+ *  @brief Provides a `SingletonHolder` creation policy placing the object in named POSIX shared memory.
+ *  @details Several processes using `policies::CreateInSharedMemory<const T>` with the same segment
+ *  name share one physical, read-only copy of `T`: the first process constructs it, later processes
+ *  attach to the existing segment and wait until construction has finished.
+ *
+ *  Memory owned by the shared object must live inside the segment and be referred to through
+ *  `OffsetPtr`, because each process may map the segment at a different address. The creating
+ *  process hands `T`'s constructor a `SharedMemoryArena` for that purpose.
+ */
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "type_id.hpp"
+
+
+namespace mosaic {
+
+    /*! @brief Pointer stored as a distance from itself, valid at any mapping address.
+     *
+     *  @details Both the `OffsetPtr` and its pointee must live in the same mapping.
+     *  An offset of 0 represents `nullptr`.
+     */
+    template <class T>
+    class OffsetPtr {
+
+    public:
+
+        OffsetPtr() noexcept = default;
+        OffsetPtr(std::nullptr_t) noexcept {}
+        OffsetPtr(T* p) noexcept { set(p); }
+
+        // Copies must be recomputed relative to their own address.
+        OffsetPtr(const OffsetPtr& other) noexcept { set(other.get()); }
+        OffsetPtr& operator=(const OffsetPtr& other) noexcept {
+            set(other.get());
+            return *this;
+        }
+        OffsetPtr& operator=(T* p) noexcept {
+            set(p);
+            return *this;
+        }
+
+        T* get() const noexcept {
+            return offset_ == 0
+                ? nullptr
+                : reinterpret_cast<T*>(reinterpret_cast<std::intptr_t>(this) + offset_);
+        }
+
+        T& operator*() const noexcept { return *get(); }
+        T* operator->() const noexcept { return get(); }
+        T& operator[](std::size_t i) const noexcept { return get()[i]; }
+        explicit operator bool() const noexcept { return offset_ != 0; }
+
+        friend bool operator==(const OffsetPtr& lhs, const OffsetPtr& rhs) noexcept {
+            return lhs.get() == rhs.get();
+        }
+        friend bool operator!=(const OffsetPtr& lhs, const OffsetPtr& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+    private:
+
+        void set(T* p) noexcept {
+            offset_ = p
+                ? reinterpret_cast<std::intptr_t>(p) - reinterpret_cast<std::intptr_t>(this)
+                : 0;
+        }
+
+        std::ptrdiff_t offset_ = 0;
+
+    };
+
+    /**************************************************/
+
+
+    /*! @brief Bump allocator over the part of a shared segment following the shared object.
+     *  @note Only usable by the creating process, while the shared object is being constructed.
+     */
+    class SharedMemoryArena {
+
+    public:
+
+        SharedMemoryArena(char* begin, std::size_t capacity) noexcept
+            : begin_(begin), capacity_(capacity) {}
+
+        /*! @throws std::bad_alloc When the arena is exhausted.
+         */
+        void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+        template <class U, class... Args>
+        U* construct(Args&&... args) {
+            return new (allocate(sizeof(U), alignof(U))) U(std::forward<Args>(args)...);
+        }
+
+        template <class U>
+        U* construct_array(std::size_t n) {
+            U* p = static_cast<U*>(allocate(n * sizeof(U), alignof(U)));
+            std::uninitialized_value_construct_n(p, n);
+            return p;
+        }
+
+        std::size_t capacity() const noexcept { return capacity_; }
+        std::size_t used() const noexcept { return used_; }
+
+    private:
+
+        char* begin_;
+        std::size_t capacity_;
+        std::size_t used_ = 0;
+
+    };
+
+    /**************************************************/
+
+
+    /*! @brief Specialize to configure the shared segment used for `T`.
+     *
+     *  @details The default takes the name from `T::shared_memory_name()` and reserves no arena.
+     *  - `name()`: POSIX shared memory object name, of the form `"/some.name"`.
+     *  - `arena_size`: bytes available to `T`'s constructor through `SharedMemoryArena`.
+     *  - `attach_timeout_ms`: how long an attaching process waits for the creator.
+     */
+    template <class T>
+    struct SharedMemoryTraits {
+        static const char* name() { return T::shared_memory_name(); }
+        static constexpr std::size_t arena_size = 0;
+        static constexpr unsigned attach_timeout_ms = 30000;
+    };
+
+
+    namespace shm_internal {
+
+        /*! @brief Fingerprint of the shared object's type.
+         *  @details A segment left by another build of the program, with the same size but
+         *  another object in it, is rejected instead of attached.
+         */
+        struct Layout {
+            std::uint64_t type_id;
+            std::uint64_t size;
+            std::uint64_t alignment;
+        };
+
+        /*! @brief Header at the start of every segment.
+         *  @note Attaching processes check the segment size, which covers `T`'s layout
+         *  and the arena, and the `Layout` of `T` against their own expectation.
+         */
+        struct SegmentHeader {
+            enum : std::uint32_t { Initializing = 0, Ready = 1, Failed = 2 };
+
+            std::atomic<std::uint32_t> state;
+            std::atomic<std::int32_t> creator;  // Process id of the constructing process, 0 until recorded.
+            Layout layout;                      // Written by the creator before it publishes the object.
+        };
+
+        static_assert(std::atomic<std::uint32_t>::is_always_lock_free && std::atomic<std::int32_t>::is_always_lock_free,
+                      "Process shared state needs address-free atomics.");
+
+        struct Mapping {
+            void* base = nullptr;
+            std::size_t size = 0;
+            Layout layout = {};
+            bool creator = false;
+        };
+
+        /*! @brief Create the segment `name` of `size` bytes, or attach to it if it exists.
+         *  @details Segments are sized under a lock, so one left empty by a creator that died
+         *  is created again. An attaching process maps the segment read-only, and returns once
+         *  it is sized: the creator has not necessarily finished constructing the object.
+         *  @throws std::system_error
+         *  @throws std::runtime_error On timeout or if the segment has another size.
+         */
+        Mapping open_or_create(const char* name, std::size_t size, const Layout& layout, unsigned timeout_ms);
+
+        /*! @brief Block until the creator publishes the object, or take over from a creator that died.
+         *  @details If the recorded creator process no longer exists, one of the waiting processes
+         *  makes the mapping writable and becomes the creator, the others keep waiting for it.
+         *  @return `false` if this process took over, it must then construct and publish the object.
+         *  @throws std::runtime_error On timeout, if the creator failed or published another `Layout`.
+         */
+        bool wait_until_ready(Mapping& mapping, const char* name, unsigned timeout_ms);
+
+        void publish(const Mapping& mapping, bool success);
+        void unmap(Mapping& mapping);
+        void unlink(const char* name);
+
+        constexpr std::size_t align_up(std::size_t n, std::size_t alignment) {
+            return (n + alignment - 1) / alignment * alignment;
+        }
+
+    } // end namespace `shm_internal`
+
+    /**************************************************/
+
+    namespace policies {
+
+        /*! @brief Creation policy placing the object in a named shared memory segment.
+         *
+         *  @details `T` is const, eg. `SingletonHolder<const Table, CreateInSharedMemory>`: the
+         *  object is built once by the creating process, and read-only from then on, so every
+         *  process gets a `const` reference.
+         *
+         *  Segment layout: header, `T`, then `SharedMemoryTraits<T>::arena_size` bytes. If `T` is
+         *  constructible from `SharedMemoryArena&` the creating process uses that constructor,
+         *  otherwise `T()`. `SharedMemoryTraits` is specialized for the unqualified type.
+         *
+         *  If the creating process dies before the object is published, an attaching process
+         *  notices and constructs it again in the same segment. The abandoned object is not destroyed.
+         *
+         *  `T` must not be polymorphic and must not hold pointers, only `OffsetPtr`s into the
+         *  segment: each process maps it at its own address, and loads the program at its own.
+         *
+         *  @note Attaching processes map the segment read-only, writing through a `const_cast` faults.
+         *  @note `destroy()` only unmaps the segment, it never runs `~T()`: other processes may
+         *  still be using the object. The segment name persists until `unlink()`.
+         */
+        template <class T>
+        class CreateInSharedMemory {
+
+            // Attaching processes map the segment read-only.
+            static_assert(std::is_const_v<T>, "Objects in shared memory are read-only, use a const type!");
+
+            using Object = std::remove_const_t<T>;
+
+            // The vtable pointer written by the creator is meaningless at another process's load address.
+            static_assert(!std::is_polymorphic_v<Object>, "Objects in shared memory cannot have virtual functions!");
+
+            using Traits = SharedMemoryTraits<Object>;
+
+            static constexpr std::size_t object_offset =
+                shm_internal::align_up(sizeof(shm_internal::SegmentHeader), alignof(Object));
+            static constexpr std::size_t arena_offset =
+                shm_internal::align_up(object_offset + sizeof(Object), alignof(std::max_align_t));
+            static constexpr std::size_t segment_size = arena_offset + Traits::arena_size;
+            static constexpr shm_internal::Layout layout = {TypeId<Object>(), sizeof(Object), alignof(Object)};
+
+        public:
+
+            static T* create() {
+                mapping_ = shm_internal::open_or_create(Traits::name(), segment_size, layout, Traits::attach_timeout_ms);
+
+                char* base = static_cast<char*>(mapping_.base);
+                Object* p_object = reinterpret_cast<Object*>(base + object_offset);
+
+                if (!mapping_.creator) {
+                    bool ready = false;
+                    try {
+                        ready = shm_internal::wait_until_ready(mapping_, Traits::name(), Traits::attach_timeout_ms);
+                    } catch (...) {
+                        shm_internal::unmap(mapping_);
+                        throw;
+                    }
+                    if (ready) {
+                        return std::launder(p_object);
+                    }
+                }
+
+                try {
+                    SharedMemoryArena arena(base + arena_offset, Traits::arena_size);
+                    if constexpr (std::is_constructible_v<Object, SharedMemoryArena&>) {
+                        new (p_object) Object(arena);
+                    } else {
+                        new (p_object) Object();
+                    }
+                } catch (...) {
+                    shm_internal::publish(mapping_, false);
+                    shm_internal::unlink(Traits::name());
+                    shm_internal::unmap(mapping_);
+                    throw;
+                }
+
+                shm_internal::publish(mapping_, true);
+                return p_object;
+            }
+
+            static void destroy(T*) {
+                shm_internal::unmap(mapping_);
+            }
+
+            /*! @brief `true` if this process constructed the shared object, possibly taking over from a dead creator.
+             */
+            static bool is_creator() noexcept {
+                return mapping_.creator;
+            }
+
+            /*! @brief Remove the segment name. Later processes will construct a fresh object.
+             */
+            static void unlink() {
+                shm_internal::unlink(Traits::name());
+            }
+
+        private:
+
+            static inline shm_internal::Mapping mapping_;
+
+        };
+
+    } // end `policies` namespace
+
+} // end namespace `mosaic`
@@ -10,6 +10,13 @@
 #include <algorithm>
 #include <cassert>
 #include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <typeinfo>
+#include "singleton_trace.hpp"
+#include "small_object.hpp"
+#include "threading.hpp"
 
 namespace mosaic {
 
@@ -61,11 +68,15 @@ namespace mosaic {
 
     namespace lifetime_impl {
 
-        class LifetimeTracker {
+        class LifetimeTracker : public SmallObject<> {
         public:
             LifetimeTracker(unsigned int x): longevity_(x) {}
             
             virtual ~LifetimeTracker() = 0;
+
+#ifdef MOSAIC_SINGLETON_TRACE
+            virtual const char* tracked_name() const = 0;
+#endif
             
             friend inline bool Compare(
                 unsigned int longevity,
@@ -113,6 +124,12 @@ namespace mosaic {
                 destroyer_(pTracked_);
             }
 
+#ifdef MOSAIC_SINGLETON_TRACE
+            const char* tracked_name() const override {
+                return trace::type_name<T>();
+            }
+#endif
+
         private:
             T* pTracked_;
             Destroyer destroyer_;
@@ -121,6 +138,7 @@ namespace mosaic {
         static void AtExitFn() {
             assert(elements > 0 && pTrackerArray != nullptr);
             LifetimeTracker* pTop = pTrackerArray[elements-1];
+            MOSAIC_TRACE_SINGLETON_SCOPE(pTop->tracked_name(), AtExit);
             
             if (--elements == 0) {   // Decrement number of elements
                 std::free(pTrackerArray);
@@ -136,6 +154,7 @@ namespace mosaic {
     /*!
      *  @note Do not apply to objects whose lifetimes are controlled by the compiler.
      *  Eg. regular global objects, static objects, and automatic objects.
+     *  @note See singleton_registry.hpp for the order relative to `policies::RegistryLifetime` singletons.
      */
     template <typename T, typename Destroyer>
     void SetLongevity(T* pDynObject, unsigned int longevity,
@@ -149,6 +168,7 @@ namespace mosaic {
         if (!pNewArray) {
             throw std::bad_alloc();
         }
+        lifetime_impl::pTrackerArray = pNewArray;
     
         // Create new `LifetimeTracker` object
         lifetime_impl::LifetimeTracker* p = new lifetime_impl::ConcreteLifeTimeTracker<T, Destroyer>(
@@ -205,6 +225,80 @@ namespace mosaic {
 
         };
 
+        /*! @brief Creation policy constructing the object on a background thread.
+         *
+         *  @details Construction starts at `launch()` (see `StartInBackground`) and runs in
+         *  parallel with the rest of the program. The first `SingletonHolder::instance()`
+         *  blocks only if construction has not finished yet, later calls take the usual
+         *  hot path. `ready()` tells, without blocking, whether the object is available.
+         *
+         *  @note An exception thrown by the constructor is rethrown by `instance()`.
+         */
+        template <class T>
+        class CreateInBackground {
+        public:
+            /*! @brief Start constructing the object, if not started already.
+             */
+            static void launch() {
+                std::lock_guard<std::mutex> guard(mutex_);
+                launch_locked();
+            }
+
+            /*! @brief `true` once the object has been constructed successfully.
+             */
+            static bool ready() {
+                std::shared_future<T*> future;
+                {
+                    std::lock_guard<std::mutex> guard(mutex_);
+                    future = construction();
+                }
+
+                if (!future.valid() || future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    return false;
+                }
+                try {
+                    future.get();
+                } catch (...) {
+                    return false;
+                }
+                return true;
+            }
+
+            static T* create() {
+                std::shared_future<T*> future;
+                {
+                    std::lock_guard<std::mutex> guard(mutex_);
+                    launch_locked();
+                    future = construction();
+                }
+                return future.get();
+            }
+            static void destroy(T* pobj) {
+                delete pobj;
+
+                // Allow recreation with a fresh `launch()`.
+                std::lock_guard<std::mutex> guard(mutex_);
+                construction() = std::shared_future<T*>();
+            }
+
+        private:
+            static void launch_locked() {
+                if (!construction().valid()) {
+                    construction() = std::async(std::launch::async, []() { return new T(); }).share();
+                }
+            }
+
+            // Constructed on first use, `launch()` may run during the dynamic initialization of another
+            // translation unit. The mutex is constant initialized.
+            static std::shared_future<T*>& construction() {
+                static std::shared_future<T*> s_construction;
+                return s_construction;
+            }
+
+            static inline std::mutex mutex_;
+
+        };
+
         template <class T>
         class DefaultLifetime {
         public:
@@ -220,11 +314,46 @@ namespace mosaic {
 
         };        
 
+        /*! @brief Lifetime policy recreating the object if it is used after destruction.
+         *
+         *  @details Suited to objects such as loggers that may be touched by other objects'
+         *  destructors during static destruction. The recreated object is scheduled for
+         *  destruction again.
+         *
+         *  @note Relies on `std::atexit` accepting registrations made while exit handlers run,
+         *  which conforming implementations (and glibc) do.
+         */
+        template <class T>
+        class PhoenixSingleton {
+        public:
+
+            using PDestructionFunction = void (*)();
+
+            static void schedule_destruction(PDestructionFunction p_destruction_function){
+                std::atexit(p_destruction_function);
+            }
+            static void on_dead_reference(){
+            }
+
+        };
+
+        /*! @brief Lifetime policy that never destroys the object.
+         *
+         *  @details The object stays usable until the process ends, and slow teardown of large
+         *  singletons is skipped at exit. The destructor never runs, so it must not be relied on
+         *  for side effects such as flushing.
+         */
         template <class T>
-        class SingleThread {
+        class NoDestroy {
         public:
-            using VolatileType = T;
-            using Lock = int;
+
+            using PDestructionFunction = void (*)();
+
+            static void schedule_destruction(PDestructionFunction){
+            }
+            static void on_dead_reference(){
+            }
+
         };
 
     } // end `policies` namespace
@@ -240,34 +369,17 @@ namespace mosaic {
         using InstanceType = typename ThreadingModel<T>::VolatileType;
 
     public:
-        // static T& instance() {
-
-        //     if (!p_instance_) {
-
-        //        [[maybe_unused]] typename ThreadingModel<T>::Lock guard;
-                
-        //         if(!p_instance_) {
-
-        //             if (destroyed_) {
-        //                 LifetimePolicy<T>::on_dead_reference();
-        //                 destroyed_ = false;
-        //             }
-
-        //             p_instance_ = CreationPolicy<T>::create();
-        //             LifetimePolicy<T>::schedule_destruction(&destroy_singleton);
-                    
-        //         }
-
-        //     }
 
-        //     return *p_instance_;
-
-        // };
+        using ObjectType = T;
+        using Creator = CreationPolicy<T>;
+        using Lifetime = LifetimePolicy<T>;
+        using Threading = ThreadingModel<T>;
 
         static T& instance() {
 
-            Singleton* temp = p_instance_.load(std::memory_order_relaxed);
-            std::atomic_thread_fence(std::memory_order_acquire);
+            // Double-checked locking. The acquire load pairs with the release store below,
+            // so a thread seeing a non-null pointer also sees the fully constructed object.
+            InstanceType* temp = p_instance_.load(std::memory_order_acquire);
             if (!temp) {
 
                 [[maybe_unused]] typename ThreadingModel<T>::Lock guard;
@@ -279,9 +391,11 @@ namespace mosaic {
                         destroyed_ = false;
                     }
 
-                    temp = CreationPolicy<T>::create();
-                    std::atomic_thread_fence(std::memory_order_release);
-                    p_instance_.store(temp, std::memory_order_relaxed);
+                    {
+                        MOSAIC_TRACE_SINGLETON_SCOPE(trace::type_name<T>(), Create);
+                        temp = CreationPolicy<T>::create();
+                    }
+                    p_instance_.store(temp, std::memory_order_release);
                     
                     LifetimePolicy<T>::schedule_destruction(&destroy_singleton);
                     
@@ -295,14 +409,15 @@ namespace mosaic {
 
     private:
         static void destroy_singleton() {
+            [[maybe_unused]] typename ThreadingModel<T>::Lock guard;
             assert(!destroyed_);
-            CreationPolicy<T>::destroy(pInstance_);
-            pInstance_ = 0;
+            MOSAIC_TRACE_SINGLETON_SCOPE(trace::type_name<T>(), Destroy);
+            CreationPolicy<T>::destroy(p_instance_.load(std::memory_order_relaxed));
+            p_instance_.store(nullptr, std::memory_order_relaxed);
             destroyed_ = true;
         };
         SingletonHolder() = delete;
 
-        // static inline InstanceType* p_instance_ = nullptr;
         static inline std::atomic<InstanceType*> p_instance_ = nullptr;
         
         static inline bool destroyed_ = false;
@@ -310,4 +425,21 @@ namespace mosaic {
 
     };
 
+    /**************************************************/
+
+    /*! @brief Starts background construction of a `SingletonHolder` using `policies::CreateInBackground`.
+     *
+     *  @details Define one at namespace scope to start construction during static initialization:
+     *  @code
+     *  using Routes = SingletonHolder<RoutingTable, policies::CreateInBackground>;
+     *  static const StartInBackground<Routes> s_start_routes;
+     *  @endcode
+     */
+    template <class Holder>
+    struct StartInBackground {
+        StartInBackground() {
+            Holder::Creator::launch();
+        }
+    };
+
 } // end `mosaic` namespace
\ No newline at end of file
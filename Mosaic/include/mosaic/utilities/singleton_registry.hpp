@@ -0,0 +1,222 @@
+#pragma once
+
+/*! @file singleton_registry.hpp
+ *  @brief Provides `SingletonRegistry` for dependency-ordered startup and shutdown of singletons.
+ *  @details Singletons declare the singletons they depend on when they are registered.
+ *  `SingletonRegistry::start()` constructs independent singletons in parallel on a `ThreadPool`,
+ *  never starting a singleton before all its dependencies exist.
+ *  Singletons using `policies::RegistryLifetime` are destroyed in reverse creation order
+ *  at `SingletonRegistry::shutdown()` (or at exit), which is a reverse topological order
+ *  of the dependency graph, without hand-picked `SetLongevity` integers.
+ *
+ *  Longevities do not rank registry singletons. The registry destroys all of them from one
+ *  `atexit` function, registered when the first one is created, while every `SetLongevity`
+ *  call registers an `atexit` function destroying the next object in longevity order. So with
+ *  `n` objects given to `SetLongevity` after the first registry singleton was created, the
+ *  first `n` objects in longevity order are destroyed first, then the registry singletons,
+ *  then the other objects. Give objects that registry singletons use in their destructors to
+ *  `SetLongevity` before creating any registry singleton, or register them too. An explicit
+ *  `shutdown()` destroys the registry singletons before any of them.
+ *
+ *  So `SetLongevity` and `policies::RegistryLifetime` must not be mixed within one dependency
+ *  graph: the relative order of the two kinds of objects follows the creation order, not the
+ *  dependencies. `add()` rejects a `RegistryLifetime` holder depending on holders with another
+ *  lifetime policy, objects given to `SetLongevity` directly cannot be checked.
+ *
+ *  `start()` creates the singletons on worker threads, so registered holders need a locking
+ *  threading model such as `policies::ClassLevelLockable`, which `add()` checks.
+ */
+
+
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "markers.hpp"
+#include "threading.hpp"
+#include "typelist.hpp"
+#include "type_id.hpp"
+
+
+namespace mosaic {
+
+    namespace policies {
+
+        template <class T>
+        class RegistryLifetime;
+
+    } // end `policies` namespace
+
+
+    namespace registry_internal {
+
+        // Holders without the `Threading` and `Lifetime` aliases of `SingletonHolder` are not checked.
+        template <class Holder, class = void>
+        struct IsSingleThreaded : std::false_type {};
+
+        template <class Holder>
+        struct IsSingleThreaded<Holder, std::void_t<typename Holder::Threading>>
+            : std::is_same<typename Holder::Threading, policies::SingleThread<typename Holder::ObjectType>> {};
+
+        template <class Holder, class = void>
+        struct HasRegistryLifetime : std::false_type {};
+
+        template <class Holder>
+        struct HasRegistryLifetime<Holder, std::void_t<typename Holder::Lifetime>>
+            : std::is_same<typename Holder::Lifetime, policies::RegistryLifetime<typename Holder::ObjectType>> {};
+
+        template <class TL>
+        struct AllHaveRegistryLifetime;
+
+        template <>
+        struct AllHaveRegistryLifetime<NullType> : std::true_type {};
+
+        template <class Head, class Tail>
+        struct AllHaveRegistryLifetime<Typelist<Head, Tail>>
+            : std::bool_constant<HasRegistryLifetime<Head>::value && AllHaveRegistryLifetime<Tail>::value> {};
+
+    } // end `registry_internal` namespace
+
+
+    class SingletonRegistry {
+
+    public:
+
+        using PCreationFunction = void (*)();
+        using PDestructionFunction = void (*)();
+
+        /*! @brief Process wide registry used by `policies::RegistryLifetime`.
+         */
+        static SingletonRegistry& instance();
+
+        SingletonRegistry() = default;
+        SingletonRegistry(const SingletonRegistry&) = delete;
+        SingletonRegistry& operator=(const SingletonRegistry&) = delete;
+        SingletonRegistry(SingletonRegistry&&) = delete;
+        SingletonRegistry& operator=(SingletonRegistry&&) = delete;
+        ~SingletonRegistry() = default;
+
+        /*! @brief Register a singleton holder and the holders it depends on.
+         *
+         *  @tparam Holder A `SingletonHolder` (anything with `ObjectType` and a static `instance()`),
+         *  whose threading model locks.
+         *  @tparam DependencyTL Typelist of holders that must be created before `Holder`.
+         *
+         *  @note Dependencies are matched on their `ObjectType` and must be registered
+         *  before `start()` is called, in any order. Without RTTI, `ObjectType`s are matched on
+         *  their `TypeId`, so they must not be unnamed or local classes of the same name.
+         */
+        template <class Holder, class DependencyTL = NullType>
+        void add() {
+            static_assert(!registry_internal::IsSingleThreaded<Holder>::value,
+                          "Singletons are created on worker threads, use a locking threading model!");
+            static_assert(!registry_internal::HasRegistryLifetime<Holder>::value
+                              || registry_internal::AllHaveRegistryLifetime<DependencyTL>::value,
+                          "Dependencies of a RegistryLifetime singleton must use RegistryLifetime too!");
+
+            std::vector<Key> dependencies;
+            DependencyKeys<DependencyTL>::append(dependencies);
+
+            add_node(
+                key_of<Holder>(),
+                []() { Holder::instance(); },
+                std::move(dependencies)
+            );
+        }
+
+        /*! @brief Create every registered singleton, in parallel where the dependencies allow it.
+         *
+         *  @param n_threads Worker threads to use, `0` for `std::thread::hardware_concurrency()`.
+         *
+         *  @throws std::logic_error On a dependency cycle or an unregistered dependency.
+         *  Nothing is created in that case.
+         *  @throws Rethrows the first exception escaping a singleton constructor,
+         *  after the singletons already running have finished.
+         */
+        void start(std::size_t n_threads = 0);
+
+        /*! @brief Destroy all scheduled singletons, last created first.
+         *  @note Safe to call more than once. Called automatically at exit for the global registry.
+         */
+        void shutdown();
+
+        /*! @brief Queue a destruction function, to be run in reverse order of scheduling.
+         */
+        void schedule_destruction(PDestructionFunction p_destruction_function);
+
+    private:
+
+        using TypeKey = policies::DefaultTypeKey;
+
+        struct Key {
+            TypeKey::KeyType type;
+            const char* name;   // For error messages.
+        };
+
+        struct Node {
+            Key key;
+            PCreationFunction create;
+            std::vector<Key> dependencies;
+        };
+
+        template <class Holder>
+        static Key key_of() {
+            using T = typename Holder::ObjectType;
+            return Key{TypeKey::OfType<T>(), TypeNameCStr<T>()};
+        }
+
+        template <class TL> struct DependencyKeys;
+
+        void add_node(Key key, PCreationFunction create, std::vector<Key> dependencies);
+
+        static void at_exit();
+
+        std::vector<Node> nodes_;
+        std::vector<PDestructionFunction> destruction_functions_;
+        bool at_exit_scheduled_ = false;
+        std::mutex mutex_;
+
+    };
+
+
+    template <>
+    struct SingletonRegistry::DependencyKeys<NullType> {
+        static void append(std::vector<Key>&) {}
+    };
+
+    template <class Head, class Tail>
+    struct SingletonRegistry::DependencyKeys<Typelist<Head, Tail>> {
+        static void append(std::vector<Key>& keys) {
+            keys.push_back(key_of<Head>());
+            DependencyKeys<Tail>::append(keys);
+        }
+    };
+
+    /**************************************************/
+
+    namespace policies {
+
+        /*! @brief Lifetime policy handing destruction over to the global `SingletonRegistry`.
+         *
+         *  @details Destruction functions are run in reverse order of creation,
+         *  so a singleton is always destroyed before the singletons it used while being built.
+         */
+        template <class T>
+        class RegistryLifetime {
+        public:
+
+            using PDestructionFunction = void (*)();
+
+            static void schedule_destruction(PDestructionFunction p_destruction_function) {
+                SingletonRegistry::instance().schedule_destruction(p_destruction_function);
+            }
+            static void on_dead_reference() {
+                throw std::runtime_error("Reuse of dead singleton detected!");
+            }
+
+        };
+
+    } // end `policies` namespace
+
+} // end namespace `mosaic`
@@ -0,0 +1,136 @@
+#pragma once
+
+/*! @file singleton_trace.hpp
+ *  @brief Opt-in timing instrumentation for singleton creation and destruction.
+ *  @details When `MOSAIC_SINGLETON_TRACE` is defined, `SingletonHolder` and the
+ *  `SetLongevity` lifetime tracker record an `Event` for every creation, destruction
+ *  and `AtExitFn` call into the global `trace::Recorder`. The recorded events can be
+ *  exported as Chrome trace JSON (`chrome://tracing`, Perfetto) or as a plain table.
+ *
+ *  Without `MOSAIC_SINGLETON_TRACE` the hooks expand to nothing.
+ *
+ *  @note Define the macro for the whole build (CMake option `MOSAIC_SINGLETON_TRACE`),
+ *  not per translation unit.
+ */
+
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <typeinfo>
+#include <vector>
+#include "type_id.hpp"
+
+
+namespace mosaic::trace {
+
+    enum class EventKind {
+        Create,     //!< `CreationPolicy::create()` inside `SingletonHolder::instance()`.
+        Destroy,    //!< `SingletonHolder` destruction function.
+        AtExit      //!< `lifetime_impl::AtExitFn` destroying an object given to `SetLongevity`.
+    };
+
+    const char* to_string(EventKind kind);
+
+
+    struct Event {
+        const char* name;           //!< Implementation defined type name of the singleton.
+        EventKind kind;
+        std::uint64_t start_ns;     //!< Nanoseconds since the recorder was created.
+        std::uint64_t duration_ns;
+        std::uint32_t thread_id;    //!< Small sequential id, `0` for the first traced thread.
+        std::uint32_t sequence;     //!< Order in which the events finished.
+    };
+
+
+    /*! @brief Process wide, thread safe store of trace events.
+     *  @note Never destroyed, so that events recorded while exiting are kept.
+     */
+    class Recorder {
+
+    public:
+
+        static Recorder& instance();
+
+        Recorder(const Recorder&) = delete;
+        Recorder& operator=(const Recorder&) = delete;
+
+        std::uint64_t now_ns() const;
+
+        void record(const char* name, EventKind kind, std::uint64_t start_ns, std::uint64_t end_ns);
+
+        std::vector<Event> events() const;
+        void clear();
+
+        /*! @brief Write events in the Chrome trace event format ("X" complete events).
+         */
+        void write_chrome_trace(std::ostream& os) const;
+
+        /*! @brief Write events as a human readable table, in sequence order.
+         */
+        void write_table(std::ostream& os) const;
+
+        /*! @brief Write a Chrome trace to `path` when the process exits.
+         *  @details `path` is copied, it need not outlive the call. A later call replaces it.
+         *  @note Call before any traced singleton is created, so that the dump
+         *  runs after all `atexit` scheduled destructions.
+         */
+        void dump_at_exit(const char* path);
+
+    private:
+
+        Recorder();
+
+        std::chrono::steady_clock::time_point epoch_;
+        std::vector<Event> events_;
+        mutable std::mutex mutex_;
+
+    };
+
+
+    /*! @brief Records one event covering its own lifetime.
+     */
+    class ScopedEvent {
+
+    public:
+
+        ScopedEvent(const char* name, EventKind kind)
+            : name_(name), kind_(kind), start_ns_(Recorder::instance().now_ns()) {}
+
+        ScopedEvent(const ScopedEvent&) = delete;
+        ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+        ~ScopedEvent() {
+            Recorder& recorder = Recorder::instance();
+            recorder.record(name_, kind_, start_ns_, recorder.now_ns());
+        }
+
+    private:
+
+        const char* name_;
+        EventKind kind_;
+        std::uint64_t start_ns_;
+
+    };
+
+    /*! @brief Name recorded for `T`, `typeid(T).name()`, or `TypeNameCStr<T>()` in builds without RTTI.
+     */
+    template <class T>
+    const char* type_name() noexcept {
+#if MOSAIC_HAS_RTTI
+        return typeid(T).name();
+#else
+        return TypeNameCStr<T>();
+#endif
+    }
+
+} // end namespace `mosaic::trace`
+
+
+#ifdef MOSAIC_SINGLETON_TRACE
+    #define MOSAIC_TRACE_SINGLETON_SCOPE(name, kind) \
+        ::mosaic::trace::ScopedEvent mosaic_trace_scoped_event_((name), ::mosaic::trace::EventKind::kind)
+#else
+    #define MOSAIC_TRACE_SINGLETON_SCOPE(name, kind) ((void)0)
+#endif
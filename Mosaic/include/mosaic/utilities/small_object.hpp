@@ -0,0 +1,489 @@
+#pragma once
+
+/*! @file small_object.hpp
+ *  @brief Provides a small-object allocator and the `SmallObject` base class routing `new`/`delete` through it.
+ *  @details Modeled on the chunk/fixed-allocator design of _Modern C++ Design_:
+ *  - `FixedAllocator` serves blocks of one size from large slabs, keeping freed blocks
+ *    in an intrusive free list. Allocation and deallocation are O(1).
+ *  - `SmallObjAllocator` keeps one `FixedAllocator` per size class (multiples of `granularity`)
+ *    and forwards larger requests to `::operator new`.
+ *  - `ThreadCache` keeps per thread free lists in front of a shared `SmallObjAllocator`,
+ *    moving blocks to and from it in batches.
+ *  - `SmallObject` gives derived classes class-level `operator new`/`operator delete`
+ *    using a process wide `SmallObjAllocator` behind one `ThreadCache` per thread.
+ *
+ *  `SmallObjAllocator::stats()` and `SmallObject::stats()` report usage, see allocator_stats.hpp.
+ */
+
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "allocator_stats.hpp"
+#include "threading.hpp"
+
+
+namespace mosaic {
+
+    /*! @brief Allocator for blocks of a single, fixed size.
+     *  @note Not thread safe. Memory is returned to the system only on destruction.
+     */
+    class FixedAllocator {
+
+    public:
+
+        /*! @param block_size Size of every block, at least `sizeof(void*)`.
+         *  @param slab_size Bytes requested from the system at once.
+         */
+        FixedAllocator(std::size_t block_size, std::size_t slab_size);
+
+        FixedAllocator(const FixedAllocator&) = delete;
+        FixedAllocator& operator=(const FixedAllocator&) = delete;
+        FixedAllocator(FixedAllocator&& other) noexcept;
+        FixedAllocator& operator=(FixedAllocator&&) = delete;
+
+        ~FixedAllocator();
+
+        void* allocate() {
+            if (free_list_) {
+                FreeBlock* block = free_list_;
+                free_list_ = block->next;
+                return block;
+            }
+            if (carve_ptr_ == carve_end_) {
+                add_slab();
+            }
+            void* block = carve_ptr_;
+            carve_ptr_ += block_size_;
+            return block;
+        }
+
+        /*! @pre `p` was returned by `allocate()` of this allocator.
+         */
+        void deallocate(void* p) noexcept {
+            FreeBlock* block = static_cast<FreeBlock*>(p);
+            block->next = free_list_;
+            free_list_ = block;
+        }
+
+        std::size_t block_size() const noexcept { return block_size_; }
+        std::size_t slab_count() const noexcept { return slabs_.size(); }
+        std::size_t bytes_reserved() const noexcept { return slabs_.size() * blocks_per_slab_ * block_size_; }
+
+    private:
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        void add_slab();
+
+        std::size_t block_size_;
+        std::size_t blocks_per_slab_;
+        FreeBlock* free_list_ = nullptr;
+        char* carve_ptr_ = nullptr;     // Never handed out part of the newest slab.
+        char* carve_end_ = nullptr;
+        std::vector<char*> slabs_;
+
+    };
+
+    /**************************************************/
+
+
+    /*! @brief Allocator dispatching to one `FixedAllocator` per size class.
+     *
+     *  @details Sizes are rounded up to a multiple of `granularity`. Since `sizeof(T)` is a
+     *  multiple of `alignof(T)`, every block is suitably aligned for any `T` of that size with
+     *  at most the default new alignment.
+     *
+     *  @note Not thread safe, see `SmallObject` for locking.
+     */
+    class SmallObjAllocator {
+
+    public:
+
+        static constexpr std::size_t granularity = alignof(void*);
+
+        SmallObjAllocator(std::size_t slab_size, std::size_t max_object_size);
+
+        SmallObjAllocator(const SmallObjAllocator&) = delete;
+        SmallObjAllocator& operator=(const SmallObjAllocator&) = delete;
+
+        void* allocate(std::size_t size) {
+            if (size > max_object_size_) {
+                void* p = ::operator new(size);
+                record(large_class(), 1, 0);
+                return p;
+            }
+            std::size_t cls = size_class(size);
+            void* p = pool_[cls].allocate();
+            record(cls, 1, 0);
+            return p;
+        }
+
+        /*! @pre `size` is the size given to `allocate()`.
+         */
+        void deallocate(void* p, std::size_t size) noexcept {
+            if (size > max_object_size_) {
+                ::operator delete(p);
+                record(large_class(), 0, 1);
+                return;
+            }
+            std::size_t cls = size_class(size);
+            pool_[cls].deallocate(p);
+            record(cls, 0, 1);
+        }
+
+        /*! @brief Block of size class `cls`, without accounting. For front ends such as `ThreadCache`.
+         */
+        void* allocate_block(std::size_t cls) { return pool_[cls].allocate(); }
+        void deallocate_block(std::size_t cls, void* p) noexcept { pool_[cls].deallocate(p); }
+
+        /*! @brief Account for allocations and frees served by a front end.
+         *  @param cls Size class, or `large_class()` for allocations forwarded to `::operator new`.
+         */
+        void record(std::size_t cls, std::size_t allocations, std::size_t frees) noexcept {
+            counters_[cls].allocations += allocations;
+            counters_[cls].frees += frees;
+            if (cls < pool_.size()) {
+                bytes_in_use_ += (static_cast<std::ptrdiff_t>(allocations) - static_cast<std::ptrdiff_t>(frees))
+                    * static_cast<std::ptrdiff_t>(class_size(cls));
+                if (bytes_in_use_ > static_cast<std::ptrdiff_t>(peak_bytes_)) {
+                    peak_bytes_ = static_cast<std::size_t>(bytes_in_use_);
+                }
+            }
+        }
+
+        void record_cross_thread_frees(std::size_t n) noexcept { cross_thread_frees_ += n; }
+
+        /*! @brief Usage snapshot, with one entry per size class and a last one for large allocations.
+         *  @details Bytes are counted at the block size of their class. Allocations forwarded to
+         *  `::operator new` are counted, but not in the byte figures.
+         */
+        AllocatorStats stats() const;
+
+        std::size_t max_object_size() const noexcept { return max_object_size_; }
+        std::size_t size_class_count() const noexcept { return pool_.size(); }
+        std::size_t large_class() const noexcept { return pool_.size(); }
+
+        std::size_t slab_count() const noexcept {
+            std::size_t count = 0;
+            for (const FixedAllocator& fixed : pool_) {
+                count += fixed.slab_count();
+            }
+            return count;
+        }
+
+        static std::size_t size_class(std::size_t size) noexcept {
+            return size == 0 ? 0 : (size - 1) / granularity;
+        }
+
+        static std::size_t class_size(std::size_t cls) noexcept {
+            return (cls + 1) * granularity;
+        }
+
+    private:
+
+        struct ClassCounters {
+            std::size_t allocations = 0;
+            std::size_t frees = 0;
+        };
+
+        std::size_t max_object_size_;
+        std::vector<FixedAllocator> pool_;
+
+        std::vector<ClassCounters> counters_;   // Last one for large allocations.
+        std::ptrdiff_t bytes_in_use_ = 0;       // Transiently negative when a front end reports frees first.
+        std::size_t peak_bytes_ = 0;
+        std::size_t cross_thread_frees_ = 0;
+
+    };
+
+    /**************************************************/
+
+
+    /*! @brief Per thread free lists in front of a shared `SmallObjAllocator`.
+     *
+     *  @details Allocation and deallocation only touch the free list of the calling thread.
+     *  An empty list takes `batch_size` blocks from the central allocator, and a list grown
+     *  past `2 * batch_size` hands `batch_size` blocks back, each under a single `Lock`.
+     *
+     *  A block may be freed by another thread than the one allocating it, as for a `Functor`
+     *  queued to a worker. It then joins the cache of the freeing thread, and flows back to
+     *  the central allocator once that cache overflows. A producer/consumer pair therefore
+     *  locks once per batch rather than once per object.
+     *
+     *  Allocations and frees are counted locally and reported to the central allocator with
+     *  each transfer, by `flush_counters()` and on destruction. Its statistics therefore lag
+     *  by at most a few batches per thread and size class.
+     *
+     *  @tparam Lock Scoped guard serializing access to the central allocator.
+     */
+    template <class Lock>
+    class ThreadCache {
+
+    public:
+
+        static constexpr std::size_t batch_size = 32;
+
+        /*! @param alive Cleared on destruction, so that frees during thread exit can bypass the cache.
+         */
+        ThreadCache(SmallObjAllocator& central, bool& alive)
+            : central_(central), alive_(alive), lists_(central.size_class_count() + 1)
+        {
+        }
+
+        ThreadCache(const ThreadCache&) = delete;
+        ThreadCache& operator=(const ThreadCache&) = delete;
+
+        ~ThreadCache() {
+            for (std::size_t cls = 0; cls < central_.size_class_count(); ++cls) {
+                release(cls, lists_[cls].count);
+            }
+            flush_counters();
+            alive_ = false;
+        }
+
+        void* allocate(std::size_t size) {
+            if (size > central_.max_object_size()) {
+                void* p = ::operator new(size);
+                ++lists_.back().allocations;
+                return p;
+            }
+            std::size_t cls = SmallObjAllocator::size_class(size);
+            FreeList& list = lists_[cls];
+            if (!list.head) {
+                refill(cls);
+            }
+            FreeBlock* block = list.head;
+            list.head = block->next;
+            --list.count;
+            ++list.allocations;
+            return block;
+        }
+
+        /*! @pre `size` is the size given to `allocate()`, on any thread sharing `central`.
+         */
+        void deallocate(void* p, std::size_t size) noexcept {
+            if (size > central_.max_object_size()) {
+                ::operator delete(p);
+                ++lists_.back().frees;
+                return;
+            }
+            std::size_t cls = SmallObjAllocator::size_class(size);
+            FreeList& list = lists_[cls];
+            FreeBlock* block = static_cast<FreeBlock*>(p);
+            block->next = list.head;
+            list.head = block;
+            // Approximation, blocks are not tagged with their owner: see `AllocatorStats::cross_thread_frees`.
+            if (++list.frees > list.allocations) {
+                ++list.cross_thread_frees;
+            }
+            if (++list.count > 2 * batch_size) {
+                release(cls, batch_size);
+            }
+        }
+
+        /*! @brief Report all counters to the central allocator.
+         */
+        void flush_counters() noexcept {
+            [[maybe_unused]] Lock guard;
+            for (std::size_t cls = 0; cls < lists_.size(); ++cls) {
+                report(cls);
+            }
+        }
+
+        std::size_t cached_blocks() const noexcept {
+            std::size_t count = 0;
+            for (const FreeList& list : lists_) {
+                count += list.count;
+            }
+            return count;
+        }
+
+    private:
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        // The last list only counts allocations forwarded to `::operator new`.
+        struct FreeList {
+            FreeBlock* head = nullptr;
+            std::size_t count = 0;
+            std::size_t allocations = 0;
+            std::size_t frees = 0;
+            std::size_t cross_thread_frees = 0;    // Frees beyond this thread's own allocations, a lower bound.
+            std::size_t reported_allocations = 0;
+            std::size_t reported_frees = 0;
+            std::size_t reported_cross_thread_frees = 0;
+        };
+
+        // Call with `Lock` held.
+        void report(std::size_t cls) noexcept {
+            FreeList& list = lists_[cls];
+            central_.record(cls, list.allocations - list.reported_allocations, list.frees - list.reported_frees);
+            central_.record_cross_thread_frees(list.cross_thread_frees - list.reported_cross_thread_frees);
+            list.reported_allocations = list.allocations;
+            list.reported_frees = list.frees;
+            list.reported_cross_thread_frees = list.cross_thread_frees;
+        }
+
+        void refill(std::size_t cls) {
+            FreeList& list = lists_[cls];
+            [[maybe_unused]] Lock guard;
+            report(cls);
+            report(lists_.size() - 1);
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                FreeBlock* block = static_cast<FreeBlock*>(central_.allocate_block(cls));
+                block->next = list.head;
+                list.head = block;
+                ++list.count;
+            }
+        }
+
+        void release(std::size_t cls, std::size_t n) noexcept {
+            if (n == 0) {
+                return;
+            }
+            FreeList& list = lists_[cls];
+            [[maybe_unused]] Lock guard;
+            report(cls);
+            report(lists_.size() - 1);
+            for (std::size_t i = 0; i < n; ++i) {
+                FreeBlock* block = list.head;
+                list.head = block->next;
+                central_.deallocate_block(cls, block);
+            }
+            list.count -= n;
+        }
+
+        SmallObjAllocator& central_;
+        bool& alive_;
+        std::vector<FreeList> lists_;
+
+    };
+
+    /**************************************************/
+
+
+    /*! @brief Base class routing `new`/`delete` of derived classes through a shared `SmallObjAllocator`.
+     *
+     *  @details Deleting through a base pointer must go through a virtual destructor,
+     *  so that the size of the most derived object reaches `operator delete`.
+     *
+     *  @tparam ThreadingModel Serializes transfers between the thread caches and the allocator, see threading.hpp.
+     *  With `policies::SingleThread` there are no caches.
+     *  @tparam slab_size Bytes per slab of every size class.
+     *  @tparam max_small_object_size Larger objects use `::operator new`.
+     *
+     *  @note The allocator is never destroyed, so that small objects can still be
+     *  freed during static destruction. Once the cache of a thread is gone, that thread
+     *  uses the allocator directly under the lock.
+     *
+     *  While `telemetry::Sampler` is active, allocations and frees are reported to it.
+     */
+    template <
+        template <class> class ThreadingModel = policies::ClassLevelLockable,
+        std::size_t slab_size = 16384,
+        std::size_t max_small_object_size = 256
+    >
+    class SmallObject {
+
+    public:
+
+        using Lock = typename ThreadingModel<SmallObject>::Lock;
+        using Cache = ThreadCache<Lock>;
+
+        // Nothing to serialize, the allocator is used directly.
+        static constexpr bool single_threaded = std::is_same_v<ThreadingModel<SmallObject>, policies::SingleThread<SmallObject>>;
+
+        static void* operator new(std::size_t size) {
+            void* p = allocate_small(size);
+            if (telemetry::Sampler::active()) {
+                telemetry::Sampler::instance().on_allocate(p, size);
+            }
+            return p;
+        }
+
+        static void operator delete(void* p, std::size_t size) noexcept {
+            if (telemetry::Sampler::active()) {
+                telemetry::Sampler::instance().on_deallocate(p);
+            }
+            deallocate_small(p, size);
+        }
+
+        // Slabs are only aligned for `new`, over-aligned classes use the global aligned allocation.
+        static void* operator new(std::size_t size, std::align_val_t alignment) {
+            return ::operator new(size, alignment);
+        }
+
+        static void operator delete(void* p, std::size_t size, std::align_val_t alignment) noexcept {
+            ::operator delete(p, size, alignment);
+        }
+
+        /*! @brief Usage snapshot, see `SmallObjAllocator::stats()`.
+         *  @note Includes the calling thread's latest operations, those of other threads may lag by a few batches.
+         */
+        static AllocatorStats stats() {
+            if constexpr (!single_threaded) {
+                if (Cache* cache = thread_cache()) {
+                    cache->flush_counters();
+                }
+            }
+            [[maybe_unused]] Lock guard;
+            return allocator().stats();
+        }
+
+        static SmallObjAllocator& allocator() {
+            static SmallObjAllocator* s_allocator = new SmallObjAllocator(slab_size, max_small_object_size);
+            return *s_allocator;
+        }
+
+        /*! @return The cache of the calling thread, `nullptr` once it has been destroyed at thread exit.
+         */
+        static Cache* thread_cache() {
+            thread_local bool t_alive = true;
+            thread_local Cache t_cache(allocator(), t_alive);
+            return t_alive ? &t_cache : nullptr;
+        }
+
+    protected:
+
+        SmallObject() = default;
+        SmallObject(const SmallObject&) = default;
+        SmallObject& operator=(const SmallObject&) = default;
+        ~SmallObject() = default;
+
+    private:
+
+        // The cache paths are discarded when `single_threaded`, so no thread cache is instantiated.
+        static void* allocate_small(std::size_t size) {
+            if constexpr (single_threaded) {
+                return allocator().allocate(size);
+            } else {
+                if (Cache* cache = thread_cache()) {
+                    return cache->allocate(size);
+                }
+                [[maybe_unused]] Lock guard;
+                return allocator().allocate(size);
+            }
+        }
+
+        static void deallocate_small(void* p, std::size_t size) noexcept {
+            if constexpr (single_threaded) {
+                allocator().deallocate(p, size);
+            } else {
+                if (Cache* cache = thread_cache()) {
+                    cache->deallocate(p, size);
+                    return;
+                }
+                [[maybe_unused]] Lock guard;
+                allocator().deallocate(p, size);
+            }
+        }
+
+    };
+
+} // end namespace `mosaic`
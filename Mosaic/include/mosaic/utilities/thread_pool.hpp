@@ -0,0 +1,77 @@
+#pragma once
+
+/*! @file thread_pool.hpp
+ *  @brief Provides a minimal fixed-size `ThreadPool`.
+ */
+
+
+#include <cstddef>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "functor.hpp"
+
+
+namespace mosaic {
+
+    /*! @brief Fixed-size pool of worker threads consuming a shared FIFO task queue.
+     *
+     *  @details Workers are started on construction and joined on destruction.
+     *  Tasks still queued when the pool is destroyed are run before the workers exit.
+     *  Tasks may submit further tasks to the same pool.
+     */
+    class ThreadPool {
+
+    public:
+
+        /*! @param n_threads Number of workers. `0` selects `std::thread::hardware_concurrency()`.
+         */
+        explicit ThreadPool(std::size_t n_threads = 0);
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+
+        ~ThreadPool();
+
+        /*! @brief Queue `fun` for execution on a worker.
+         *  @return Future for the result (or exception) of `fun`.
+         */
+        template <class Fun>
+        std::future<std::invoke_result_t<std::decay_t<Fun>>> submit(Fun&& fun) {
+
+            using ResultT = std::invoke_result_t<std::decay_t<Fun>>;
+
+            // `Functor` requires copyable callables, `packaged_task` is move only.
+            auto sp_task = std::make_shared<std::packaged_task<ResultT()>>(std::forward<Fun>(fun));
+            std::future<ResultT> result = sp_task->get_future();
+
+            push(Functor<void>([sp_task]() { (*sp_task)(); }));
+
+            return result;
+        }
+
+        std::size_t size() const noexcept {
+            return workers_.size();
+        }
+
+    private:
+
+        void push(Functor<void> task);
+        void worker_loop();
+
+        std::vector<std::thread> workers_;
+        std::deque<Functor<void>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stopping_ = false;
+
+    };
+
+} // end namespace `mosaic`
@@ -0,0 +1,50 @@
+#pragma once
+
+/*! @file threading.hpp
+ *  @brief Threading model policies.
+ *  @details A threading model `ThreadingModel<T>` provides:
+ *  - `VolatileType`: the type to use for shared instances of `T`.
+ *  - `Lock`: a default constructible scoped guard serializing access among users of `ThreadingModel<T>`.
+ */
+
+
+#include <mutex>
+
+
+namespace mosaic {
+
+    namespace policies {
+
+        /*! @brief Threading model for single threaded use, `Lock` does nothing.
+         */
+        template <class T>
+        class SingleThread {
+        public:
+            using VolatileType = T;
+            using Lock = int;
+        };
+
+        /*! @brief Threading model serializing users with one mutex per `T`.
+         *  @note For `SingletonHolder` only the slow path (first use, destruction) locks,
+         *  `instance()` on an existing object is a single acquire load.
+         */
+        template <class T>
+        class ClassLevelLockable {
+        public:
+            using VolatileType = T;
+
+            class Lock {
+            public:
+                Lock() { mutex_.lock(); }
+                Lock(const Lock&) = delete;
+                Lock& operator=(const Lock&) = delete;
+                ~Lock() { mutex_.unlock(); }
+            };
+
+        private:
+            static inline std::mutex mutex_;
+        };
+
+    } // end `policies` namespace
+
+} // end namespace `mosaic`
@@ -0,0 +1,179 @@
+#pragma once
+
+/*! @file type_id.hpp
+ *  @brief Provides `TypeId<T>()` and `TypeName<T>()`, identifying types at compile time without RTTI,
+ *  and the type key policies selecting between them and `TypeInfo`.
+ *  @details The name is cut out of the compiler's signature string of a function template
+ *  instantiated for `T` (`__PRETTY_FUNCTION__`, or `__FUNCSIG__` with MSVC), and the id is its
+ *  64 bit FNV-1a hash. Both are `constexpr`, so the id can be a template argument or a `case` label:
+ *
+ *  @code
+ *  switch (shape.type_id()) {
+ *      case TypeId<Circle>(): ...
+ *      case TypeId<Square>(): ...
+ *  }
+ *  @endcode
+ *
+ *  Ids are stable across runs and translation units of a given compiler, not across compilers,
+ *  whose names differ. Classes of anonymous namespaces share the name of their namespace, hence
+ *  their ids, across translation units.
+ */
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+#include "type_info.hpp"
+
+
+#if defined(__cpp_rtti) || defined(__GXX_RTTI) || defined(_CPPRTTI)
+    #define MOSAIC_HAS_RTTI 1
+#else
+    #define MOSAIC_HAS_RTTI 0
+#endif
+
+
+namespace mosaic {
+
+    namespace type_id_internal {
+
+        template <class T>
+        constexpr std::string_view signature() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+            return __FUNCSIG__;
+#else
+            return __PRETTY_FUNCTION__;
+#endif
+        }
+
+        // The name sits between the same prefix and suffix in every signature, measure them on a known type.
+        constexpr std::string_view probe = signature<double>();
+        constexpr std::size_t prefix = probe.rfind("double");
+        constexpr std::size_t suffix = probe.size() - prefix - std::string_view("double").size();
+
+        static_assert(prefix != std::string_view::npos, "Unsupported compiler signature format!");
+
+        constexpr std::uint64_t fnv1a(std::string_view bytes) noexcept {
+            std::uint64_t hash = 0xCBF29CE484222325ull;
+            for (const char byte : bytes) {
+                hash = (hash ^ static_cast<unsigned char>(byte)) * 0x100000001B3ull;
+            }
+            return hash;
+        }
+
+    } // end `type_id_internal` namespace
+
+
+    /*! @brief Readable name of `T`, as spelled by the compiler, eg. `mosaic::TypeInfo`.
+     */
+    template <class T>
+    constexpr std::string_view TypeName() noexcept {
+        constexpr std::string_view full = type_id_internal::signature<T>();
+        return full.substr(type_id_internal::prefix, full.size() - type_id_internal::prefix - type_id_internal::suffix);
+    }
+
+    /*! @brief 64 bit id of `T`, the FNV-1a hash of `TypeName<T>()`.
+     *  @details Cv-qualified types have ids of their own.
+     */
+    template <class T>
+    constexpr std::uint64_t TypeId() noexcept {
+        constexpr std::uint64_t id = type_id_internal::fnv1a(TypeName<T>());
+        return id;
+    }
+
+
+    namespace type_id_internal {
+
+        template <class T, std::size_t... i>
+        constexpr std::array<char, sizeof...(i) + 1> terminated_name(std::index_sequence<i...>) noexcept {
+            return {{ TypeName<T>()[i]..., '\0' }};
+        }
+
+        // `TypeName<T>()` points into a longer signature, this copy ends the name with a null character.
+        template <class T>
+        inline constexpr auto c_name = terminated_name<T>(std::make_index_sequence<TypeName<T>().size()>{});
+
+    } // end `type_id_internal` namespace
+
+
+    /*! @brief `TypeName<T>()` as a null terminated string, for interfaces taking a `const char*`.
+     */
+    template <class T>
+    constexpr const char* TypeNameCStr() noexcept {
+        return type_id_internal::c_name<T>.data();
+    }
+
+
+    namespace policies {
+
+#if MOSAIC_HAS_RTTI
+
+        /*! @brief Type key policy identifying types by their `TypeInfo`, the dynamic type of objects with RTTI.
+         *
+         *  @details A type key policy provides the key type `KeyType`, `OfType<T>()` for the key of a
+         *  type and `OfObject(object)` for the key of the dynamic type of `object`. Dispatchers and
+         *  factories finding objects by their dynamic type take one.
+         */
+        struct TypeInfoKey {
+
+            using KeyType = TypeInfo;
+
+            template <class T>
+            static KeyType OfType() { return typeid(T); }
+
+            template <class T>
+            static KeyType OfObject(const T& object) { return typeid(object); }
+
+        };
+
+#endif
+
+        /*! @brief Type key policy identifying types by their `TypeId`, for builds without RTTI.
+         *  @details Objects report their dynamic type through a virtual `type_id()`,
+         *  defined with `MOSAIC_DEFINE_TYPE_ID` in the root and `MOSAIC_OVERRIDE_TYPE_ID` in derived classes.
+         */
+        struct TypeIdKey {
+
+            using KeyType = std::uint64_t;
+
+            template <class T>
+            static constexpr KeyType OfType() noexcept { return TypeId<T>(); }
+
+            template <class T>
+            static KeyType OfObject(const T& object) { return object.type_id(); }
+
+        };
+
+        /*! @brief `TypeInfoKey`, or `TypeIdKey` in builds without RTTI.
+         */
+#if MOSAIC_HAS_RTTI
+        using DefaultTypeKey = TypeInfoKey;
+#else
+        using DefaultTypeKey = TypeIdKey;
+#endif
+
+    } // end namespace `policies`
+
+} // end namespace `mosaic`
+
+
+/*! @brief Define the virtual `type_id()` member of `SomeClass`, returning `TypeId<SomeClass>()`.
+ *  @details For the root of the hierarchy, which may declare it pure instead.
+ *  Derived classes use `MOSAIC_OVERRIDE_TYPE_ID`.
+ */
+#define MOSAIC_DEFINE_TYPE_ID(SomeClass) \
+    virtual std::uint64_t type_id() const { \
+        return ::mosaic::TypeId<SomeClass>(); \
+    }
+
+/*! @brief Override `type_id()` in `SomeClass`, derived from a class declaring it, to return `TypeId<SomeClass>()`.
+ *  @details Every class below the root defines it. Unlike `MOSAIC_DEFINE_TYPE_ID`, it does not trip
+ *  `-Winconsistent-missing-override` in classes marking their other overrides `override`.
+ */
+#define MOSAIC_OVERRIDE_TYPE_ID(SomeClass) \
+    std::uint64_t type_id() const override { \
+        return ::mosaic::TypeId<SomeClass>(); \
+    }
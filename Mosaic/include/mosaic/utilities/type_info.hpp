@@ -6,8 +6,11 @@
  *      - All the member functions of `type_info`.    
  *      - Value semantics (copy constructor and assignment operator).
  *      - Seamless comparisons through `operator<` and `operator==`.
+ *      - A `std::hash` specialization, returning the hash code cached on construction.
  */
 
+#include <cstddef>
+#include <functional>
 #include <typeinfo>
 
 namespace mosaic {
@@ -18,15 +21,22 @@ public:
 
     TypeInfo() = default;  // Needed for containers.
     TypeInfo(const std::type_info& t_info);
-    TypeInfo(const TypeInfo&);
-    TypeInfo& operator=(const TypeInfo&);
+    TypeInfo(const TypeInfo&) noexcept;
+    TypeInfo& operator=(const TypeInfo&) noexcept;
 
     bool before(const TypeInfo&) const;
     const char* name() const;
 
+    // Wrapped `type_info`, the wrapper must not be default constructed.
+    const std::type_info& get() const { return *pInfo_; }
+
+    // `type_info::hash_code()`, computed once.
+    std::size_t hash_code() const noexcept { return hash_; }
+
 private:
 
     const std::type_info *pInfo_ = nullptr;
+    std::size_t hash_ = 0;
 
 
     friend bool operator==(const TypeInfo& lhs, const TypeInfo& rhs);
@@ -47,4 +57,14 @@ bool operator>(const TypeInfo& lhs, const TypeInfo& rhs);
 bool operator>=(const TypeInfo& lhs, const TypeInfo& rhs);
 
 
-} // end namespace mosaic
\ No newline at end of file
+} // end namespace mosaic
+
+
+namespace std {
+
+template <>
+struct hash<mosaic::TypeInfo> {
+    std::size_t operator()(const mosaic::TypeInfo& t_info) const noexcept { return t_info.hash_code(); }
+};
+
+} // end namespace std
\ No newline at end of file
@@ -388,6 +388,24 @@ public:
 /**************************************************/
 
 
+/** @brief Reverse the order of the types in the typelist.
+ *  @tparam TL Typelist.
+ */
+template <class TL> struct Reverse;
+
+template <>
+struct Reverse <NullType> {
+    using Result = NullType;
+};
+
+template <class Head, class Tail>
+struct Reverse <Typelist<Head, Tail>> {
+    using Result = typename Append<typename Reverse<Tail>::Result, Head>::Result;
+};
+
+/**************************************************/
+
+
 } // end namespace `tl`
 
 } // end namespace `mosaic`
\ No newline at end of file
@@ -0,0 +1,312 @@
+#pragma once
+
+/*! @file visitor.hpp
+ *  @brief Provides `CyclicVisitor`, a visitor interface generated from the typelist of visitable classes,
+ *  and `DenseVisit()`, dispatching on a type index stored in the visited objects.
+ *  @details A cyclic visitor has one pure virtual `Visit(T&)` per visitable class `T`, and every
+ *  visitable class an `Accept()` calling back the visitor's overload for its own type. A visit is
+ *  two virtual calls and no cast, at the cost of recompiling the visitors when a class is added.
+ *
+ *  @code
+ *  class Circle;
+ *  class Square;
+ *  using ShapeVisitor = CyclicVisitor<void, MakeTL<Circle, Square>::TL>;
+ *
+ *  struct Shape {
+ *      virtual ~Shape() = default;
+ *      virtual void Accept(ShapeVisitor&) = 0;
+ *  };
+ *  struct Circle : Shape {
+ *      MOSAIC_DEFINE_CYCLIC_VISITABLE(ShapeVisitor)
+ *  };
+ *  @endcode
+ *
+ *  Dense visitation instead stores in each object the index of its class in the typelist.
+ *  `DenseVisit(visitor, object)` loads it and calls through a `constexpr` table, straight into
+ *  the visitor's non-virtual `Visit()` overload, which the table entry inlines. Visitors are
+ *  plain classes, and the hierarchy needs no `Accept()`.
+ *
+ *  `VisitAll(range, visitor)` visits a whole collection grouped by type, so that each type's
+ *  `Visit()` runs in a loop of its own, free of indirect calls and branch mispredictions.
+ */
+
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "hierarchy_generators.hpp"
+#include "typelist.hpp"
+
+
+namespace mosaic {
+
+    /*! @brief Unit of `CyclicVisitor`, visiting one class `T`.
+     */
+    template <class T, typename R = void>
+    class Visitor {
+
+    public:
+
+        using ReturnType = R;
+
+        virtual R Visit(T&) = 0;
+        virtual ~Visitor() = default;
+
+    };
+
+
+    namespace visitor_internal {
+
+        // Binds the return type, `GenScatterHierarchy` takes single parameter units.
+        template <typename R>
+        struct VisitorBinder {
+            template <class T>
+            using Result = Visitor<T, R>;
+        };
+
+    } // end `visitor_internal` namespace
+
+
+    /*! @brief Visitor of every class of `TList`, with a pure virtual `Visit(T&)` for each.
+     *  @details Concrete visitors derive from it and override every `Visit()`.
+     *  Visitable classes implement `Accept()` with `MOSAIC_DEFINE_CYCLIC_VISITABLE`.
+     */
+    template <typename R, class TList>
+    class CyclicVisitor
+        : public GenScatterHierarchy<TList, visitor_internal::VisitorBinder<R>::template Result>
+    {
+
+    public:
+
+        using ReturnType = R;
+        using VisitableList = TList;
+
+        /*! @brief Call the `Visit()` overload of `Visited`, without overload resolution
+         *  against the other classes, eg. base classes also in `TList`.
+         */
+        template <class Visited>
+        ReturnType GenericVisit(Visited& host) {
+            Visitor<Visited, ReturnType>& unit = *this;
+            return unit.Visit(host);
+        }
+
+    };
+
+    /**************************************************/
+
+    /*! @brief Root of a hierarchy visitable with `DenseVisit()`, storing the type index of the object.
+     *
+     *  @details Each class `T` of `TList` derives from it through `DenseVisitable<T, Base>`,
+     *  which records `tl::IndexOf<TList, T>`. The constructor of the most derived class runs last,
+     *  so the index is the one of the dynamic type.
+     *
+     *  @code
+     *  struct Circle;
+     *  struct Square;
+     *  struct Shape : DenseVisitableBase<MakeTL<Circle, Square>::TL> {};
+     *  struct Circle : DenseVisitable<Circle, Shape> {};
+     *  struct Square : DenseVisitable<Square, Shape> {};
+     *  @endcode
+     *
+     *  Objects whose dynamic type has no `DenseVisitable` layer keep the index `tl::Length<TList>`,
+     *  out of range of the dispatch tables, which debug builds assert on.
+     *
+     *  @note Classes of `TList` must not derive virtually from the root, they are reached with `static_cast`.
+     */
+    template <class TList>
+    class DenseVisitableBase {
+
+    public:
+
+        using VisitableList = TList;
+
+        static_assert(tl::Length<TList>::value < 256, "Too many visitable types for an 8 bit index!");
+
+        std::size_t type_index() const noexcept { return type_index_; }
+
+    protected:
+
+        DenseVisitableBase() = default;
+        ~DenseVisitableBase() = default;
+
+        std::uint8_t type_index_ = static_cast<std::uint8_t>(tl::Length<TList>::value);
+
+    };
+
+
+    /*! @brief Layer recording `Derived`'s index in the `DenseVisitableBase` of `Base`.
+     *  @details Constructor arguments are forwarded to `Base`.
+     */
+    template <class Derived, class Base>
+    class DenseVisitable : public Base {
+
+    public:
+
+        static constexpr int type_index_value = tl::IndexOf<typename Base::VisitableList, Derived>::value;
+
+        static_assert(type_index_value != -1, "Class is not in the visitable typelist!");
+
+        template <class... Args>
+        explicit DenseVisitable(Args&&... args) : Base(std::forward<Args>(args)...) {
+            this->type_index_ = static_cast<std::uint8_t>(type_index_value);
+        }
+
+    };
+
+
+    /*! @brief Order in which `VisitAll()` visits a collection.
+     */
+    enum class VisitOrder {
+        by_type,    //!< Every object of the first type of the typelist, then of the second... Stable within a type.
+        preserve    //!< The order of the collection.
+    };
+
+
+    namespace visitor_internal {
+
+        // `T` with the constness of `Node`.
+        template <class Node, class T>
+        using Visited = std::conditional_t<std::is_const_v<Node>, const T, T>;
+
+        template <class VisitorT, class Node, class TList>
+        struct DenseDispatcher {
+
+            static constexpr std::size_t size = tl::Length<TList>::value;
+
+            template <std::size_t i>
+            using VisitedAt = Visited<Node, typename tl::TypeAt<TList, static_cast<int>(i)>::Result>;
+
+            using ReturnType = decltype(std::declval<VisitorT&>().Visit(std::declval<VisitedAt<0>&>()));
+
+            template <std::size_t i>
+            static ReturnType visit(VisitorT& visitor, Node& node) {
+                return visitor.Visit(static_cast<VisitedAt<i>&>(node));
+            }
+
+            template <std::size_t... i>
+            static constexpr auto make_table(std::index_sequence<i...>) noexcept {
+                return std::array<ReturnType (*)(VisitorT&, Node&), size>{{ &visit<i>... }};
+            }
+
+            static constexpr auto table = make_table(std::make_index_sequence<size>{});
+
+            template <std::size_t i>
+            static void visit_run(VisitorT& visitor, Node* const* first, Node* const* last) {
+                for (; first != last; ++first) {
+                    visitor.Visit(static_cast<VisitedAt<i>&>(**first));
+                }
+            }
+
+            // `bounds[i]` to `bounds[i + 1]` are the nodes of type index `i` in `nodes`.
+            template <std::size_t... i>
+            static void visit_runs(VisitorT& visitor, Node* const* nodes, const std::size_t* bounds, std::index_sequence<i...>) {
+                (visit_run<i>(visitor, nodes + bounds[i], nodes + bounds[i + 1]), ...);
+            }
+
+        };
+
+        template <class VisitorT, class = void>
+        struct DefaultVisitOrder {
+            static constexpr auto value = VisitOrder::by_type;
+        };
+
+        template <class VisitorT>
+        struct DefaultVisitOrder<VisitorT, std::void_t<decltype(VisitorT::visit_order)>> {
+            static constexpr VisitOrder value = VisitorT::visit_order;
+        };
+
+        template <class Range, class = void>
+        struct IsSized : std::false_type {};
+
+        template <class Range>
+        struct IsSized<Range, std::void_t<decltype(std::size(std::declval<Range&>()))>> : std::true_type {};
+
+    } // end `visitor_internal` namespace
+
+
+    /*! @brief Call `visitor.Visit(object)` with `object` cast to its dynamic type.
+     *
+     *  @details One load of the type index and one indirect call through a `constexpr` table.
+     *  `VisitorT` needs a `Visit()` overload for every class of the typelist, with the same return type.
+     *  Overloads are resolved statically, so one taking a base class covers its derived classes.
+     *
+     *  @tparam Node A class deriving from `DenseVisitableBase`, possibly const.
+     */
+    template <class VisitorT, class Node>
+    decltype(auto) DenseVisit(VisitorT& visitor, Node& node) {
+        using Dispatcher = visitor_internal::DenseDispatcher<VisitorT, Node, typename Node::VisitableList>;
+        const std::size_t i = node.type_index();
+        assert(i < Dispatcher::size);
+        return Dispatcher::table[i](visitor, node);
+    }
+
+
+    /*! @brief `DenseVisit(visitor, *element)` for every element of `range`, grouped by type.
+     *
+     *  @details With `VisitOrder::by_type`, a first pass buckets the objects by type index (a
+     *  counting sort of pointers), then each type's `Visit()` runs over its bucket in a loop of its
+     *  own, where it is inlined and the branches are predictable. A visitor whose results depend on
+     *  the visiting order declares `static constexpr VisitOrder visit_order = VisitOrder::preserve;`,
+     *  which selects a plain `DenseVisit()` loop by default.
+     *
+     *  @param range Range of pointers (or smart pointers) to a class deriving from `DenseVisitableBase`,
+     *  with forward iterators: grouping by type iterates over it twice.
+     *  @param order Defaults to `VisitorT::visit_order` if declared, `VisitOrder::by_type` otherwise.
+     */
+    template <class Range, class VisitorT>
+    void VisitAll(Range&& range, VisitorT& visitor, VisitOrder order = visitor_internal::DefaultVisitOrder<VisitorT>::value) {
+        using Node = std::remove_reference_t<decltype(**std::begin(range))>;
+        using Dispatcher = visitor_internal::DenseDispatcher<VisitorT, Node, typename Node::VisitableList>;
+        constexpr std::size_t size = Dispatcher::size;
+
+        using Category = typename std::iterator_traits<decltype(std::begin(range))>::iterator_category;
+        static_assert(std::is_base_of_v<std::forward_iterator_tag, Category>, "VisitAll() needs a multi-pass range!");
+
+        if (order == VisitOrder::preserve) {
+            for (auto&& element : range) {
+                DenseVisit(visitor, *element);
+            }
+            return;
+        }
+
+        // Count per type, remembering the indices so that the objects are read once.
+        std::vector<std::uint8_t> indices;
+        if constexpr (visitor_internal::IsSized<Range>::value) {
+            indices.reserve(std::size(range));
+        }
+        std::array<std::size_t, size + 1> bounds{};
+        for (auto&& element : range) {
+            const std::size_t i = (*element).type_index();
+            assert(i < size);
+            indices.push_back(static_cast<std::uint8_t>(i));
+            ++bounds[i + 1];
+        }
+        for (std::size_t i = 1; i <= size; ++i) {
+            bounds[i] += bounds[i - 1];
+        }
+
+        std::vector<Node*> nodes(indices.size());
+        std::array<std::size_t, size + 1> next = bounds;
+        std::size_t k = 0;
+        for (auto&& element : range) {
+            nodes[next[indices[k++]]++] = &*element;
+        }
+
+        Dispatcher::visit_runs(visitor, nodes.data(), bounds.data(), std::make_index_sequence<size>{});
+    }
+
+} // end namespace `mosaic`
+
+
+/*! @brief Define the `Accept()` member of a class visitable by the `CyclicVisitor` `SomeVisitor`.
+ *  @details The class must be in `SomeVisitor::VisitableList`.
+ */
+#define MOSAIC_DEFINE_CYCLIC_VISITABLE(SomeVisitor) \
+    virtual SomeVisitor::ReturnType Accept(SomeVisitor& guest) { \
+        return guest.GenericVisit(*this); \
+    }
@@ -0,0 +1,151 @@
+/*! @file allocator_stats.cpp
+ *  @brief Implementation for the allocation call site `Sampler`.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <ostream>
+#include "mosaic/utilities/allocator_stats.hpp"
+
+#if MOSAIC_HAS_BACKTRACE
+    #include <execinfo.h>
+#endif
+
+namespace mosaic::telemetry {
+
+#if MOSAIC_HAS_BACKTRACE
+
+namespace {
+
+    // The frame of `on_allocate` itself. `SmallObject::operator new` is usually inlined into the call site.
+    constexpr int skipped_frames = 1;
+
+} // end anonymous namespace
+
+#endif
+
+
+Sampler& Sampler::instance()
+{
+    static Sampler* s_sampler = new Sampler();
+    return *s_sampler;
+}
+
+void Sampler::start(std::size_t period)
+{
+    period_.store(std::max<std::size_t>(period, 1), std::memory_order_relaxed);
+    s_active.store(true, std::memory_order_relaxed);
+}
+
+void Sampler::stop() noexcept
+{
+    period_.store(0, std::memory_order_relaxed);
+}
+
+void Sampler::clear()
+{
+    stop();
+    std::lock_guard<std::mutex> guard(mutex_);
+    samples_.clear();
+    for (auto& count : filter_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    s_active.store(false, std::memory_order_relaxed);
+}
+
+std::size_t Sampler::bucket(const void* p) noexcept
+{
+    auto address = reinterpret_cast<std::uintptr_t>(p);
+    return ((address >> 4) ^ (address >> 16)) % filter_size;
+}
+
+void Sampler::on_allocate(const void* p, std::size_t size)
+{
+    std::size_t period = period_.load(std::memory_order_relaxed);
+    if (period == 0) {
+        return;
+    }
+
+    thread_local std::size_t t_countdown = 0;
+    if (t_countdown > 0 && t_countdown <= period) {
+        --t_countdown;
+        return;
+    }
+    t_countdown = period - 1;
+
+    Sample sample{size, {}};
+#if MOSAIC_HAS_BACKTRACE
+    void* stack[CallSite::max_depth + skipped_frames];
+    int depth = ::backtrace(stack, CallSite::max_depth + skipped_frames);
+    for (int i = skipped_frames; i < depth; ++i) {
+        sample.frames[i - skipped_frames] = stack[i];
+    }
+#endif
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (samples_.insert_or_assign(p, sample).second) {
+        filter_[bucket(p)].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Sampler::on_deallocate(const void* p) noexcept
+{
+    auto& count = filter_[bucket(p)];
+    if (count.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (samples_.erase(p)) {
+        count.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+std::vector<CallSite> Sampler::live_call_sites() const
+{
+    std::map<std::array<void*, CallSite::max_depth>, CallSite> sites;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        for (const auto& [p, sample] : samples_) {
+            CallSite& site = sites.try_emplace(sample.frames, CallSite{sample.frames, 0, 0}).first->second;
+            ++site.allocations;
+            site.bytes += sample.size;
+        }
+    }
+
+    std::vector<CallSite> result;
+    result.reserve(sites.size());
+    for (const auto& entry : sites) {
+        result.push_back(entry.second);
+    }
+    std::sort(result.begin(), result.end(), [](const CallSite& lhs, const CallSite& rhs) {
+        return lhs.bytes > rhs.bytes;
+    });
+    return result;
+}
+
+void Sampler::write_report(std::ostream& os) const
+{
+    std::vector<CallSite> sites = live_call_sites();
+
+    os << "live sampled allocations, 1 in " << period() << '\n';
+    for (const CallSite& site : sites) {
+        os << site.allocations << " allocations, " << site.bytes << " bytes\n";
+
+#if MOSAIC_HAS_BACKTRACE
+        int depth = 0;
+        while (depth < static_cast<int>(CallSite::max_depth) && site.frames[depth]) {
+            ++depth;
+        }
+        char** symbols = ::backtrace_symbols(site.frames.data(), depth);
+        for (int i = 0; i < depth; ++i) {
+            os << "    " << (symbols ? symbols[i] : "?") << '\n';
+        }
+        std::free(symbols);
+#endif
+    }
+}
+
+} // end namespace `mosaic::telemetry`
@@ -0,0 +1,137 @@
+/*! @file arena.cpp
+ *  @brief Implementation for `MonotonicArena`.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include "mosaic/utilities/arena.hpp"
+
+namespace mosaic {
+
+namespace {
+
+    char* align_up(char* p, std::size_t alignment) noexcept {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        return reinterpret_cast<char*>((address + alignment - 1) & ~(alignment - 1));
+    }
+
+} // end anonymous namespace
+
+
+MonotonicArena::MonotonicArena(std::pmr::memory_resource* upstream)
+    : MonotonicArena(default_chunk_size, upstream)
+{
+}
+
+MonotonicArena::MonotonicArena(std::size_t initial_chunk_size, std::pmr::memory_resource* upstream)
+    : upstream_(upstream),
+      buffer_(nullptr),
+      buffer_size_(0),
+      initial_chunk_size_(std::max(initial_chunk_size, header_size + alignof(std::max_align_t))),
+      next_chunk_size_(initial_chunk_size_)
+{
+}
+
+MonotonicArena::MonotonicArena(void* buffer, std::size_t size, std::pmr::memory_resource* upstream)
+    : upstream_(upstream),
+      buffer_(static_cast<char*>(buffer)),
+      buffer_size_(size),
+      initial_chunk_size_(default_chunk_size),
+      next_chunk_size_(initial_chunk_size_),
+      ptr_(buffer_),
+      end_(buffer_ + size),
+      capacity_(size)
+{
+}
+
+MonotonicArena::~MonotonicArena()
+{
+    release();
+}
+
+void MonotonicArena::reset() noexcept
+{
+    current_ = nullptr;
+    ptr_ = buffer_;
+    end_ = buffer_ + buffer_size_;
+    bytes_used_ = 0;
+}
+
+void MonotonicArena::release() noexcept
+{
+    while (head_) {
+        Chunk* next = head_->next;
+        upstream_->deallocate(head_, head_->size, alignof(std::max_align_t));
+        head_ = next;
+    }
+    capacity_ = buffer_size_;
+    chunk_count_ = 0;
+    next_chunk_size_ = initial_chunk_size_;
+    reset();
+}
+
+void* MonotonicArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    bytes = std::max<std::size_t>(bytes, 1);
+
+    char* p = align_up(ptr_, alignment);
+    if (reinterpret_cast<std::uintptr_t>(p) + bytes > reinterpret_cast<std::uintptr_t>(end_)) {
+        next_chunk(bytes, alignment);
+        p = align_up(ptr_, alignment);
+    }
+
+    bytes_used_ += static_cast<std::size_t>(p - ptr_) + bytes;
+    high_water_mark_ = std::max(high_water_mark_, bytes_used_);
+    ++allocations_;
+    ptr_ = p + bytes;
+    return p;
+}
+
+AllocatorStats MonotonicArena::stats() const
+{
+    AllocatorStats stats;
+    stats.bytes_in_use = bytes_used_;
+    stats.peak_bytes = high_water_mark_;
+    stats.bytes_reserved = capacity_;
+    stats.slab_count = chunk_count_;
+    stats.allocations = allocations_;
+    return stats;
+}
+
+void MonotonicArena::next_chunk(std::size_t bytes, std::size_t alignment)
+{
+    std::size_t needed = header_size + bytes + alignment;
+
+    // Chunks kept from before the last `reset()` come first.
+    Chunk* kept = current_ ? current_->next : head_;
+    if (kept && kept->size >= needed) {
+        use_chunk(kept);
+        return;
+    }
+
+    std::size_t size = std::max(next_chunk_size_, needed);
+    Chunk* chunk = static_cast<Chunk*>(upstream_->allocate(size, alignof(std::max_align_t)));
+    chunk->size = size;
+
+    // A kept chunk too small for this request stays in the list for later ones.
+    chunk->next = kept;
+    if (current_) {
+        current_->next = chunk;
+    } else {
+        head_ = chunk;
+    }
+
+    capacity_ += size;
+    ++chunk_count_;
+    next_chunk_size_ = size * 2;
+    use_chunk(chunk);
+}
+
+void MonotonicArena::use_chunk(Chunk* chunk) noexcept
+{
+    current_ = chunk;
+    ptr_ = reinterpret_cast<char*>(chunk) + header_size;
+    end_ = reinterpret_cast<char*>(chunk) + chunk->size;
+}
+
+} // end namespace `mosaic`
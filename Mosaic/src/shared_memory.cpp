@@ -0,0 +1,210 @@
+/*! @file shared_memory.cpp
+ *  @brief Implementation for the POSIX shared memory segments behind `CreateInSharedMemory`.
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mosaic/utilities/shared_memory.hpp"
+
+namespace mosaic {
+
+void* SharedMemoryArena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    std::size_t offset = shm_internal::align_up(used_, alignment);
+    if (offset + bytes > capacity_) {
+        throw std::bad_alloc();
+    }
+    used_ = offset + bytes;
+    return begin_ + offset;
+}
+
+namespace shm_internal {
+
+namespace {
+
+    [[noreturn]] void throw_errno(const std::string& what, const char* name)
+    {
+        throw std::system_error(errno, std::generic_category(), what + " '" + name + "'");
+    }
+
+    // RAII file descriptor, the mapping stays valid after `close()`.
+    struct Descriptor {
+        int fd;
+        ~Descriptor() { if (fd >= 0) ::close(fd); }
+    };
+
+    // RAII `flock()`. Closing the descriptor would not release it, the mapping keeps the file open.
+    struct Lock {
+        int fd;
+        ~Lock() { ::flock(fd, LOCK_UN); }
+    };
+
+    void* map(int fd, std::size_t size, int protection, const char* name)
+    {
+        void* base = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            throw_errno("mmap failed for shared memory", name);
+        }
+        return base;
+    }
+
+    SegmentHeader* header(const Mapping& mapping)
+    {
+        return static_cast<SegmentHeader*>(mapping.base);
+    }
+
+    std::chrono::steady_clock::time_point deadline_after(unsigned timeout_ms)
+    {
+        return std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+
+    int lock_before(int fd, std::chrono::steady_clock::time_point deadline, const char* name)
+    {
+        while (::flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            if (errno != EWOULDBLOCK && errno != EINTR) {
+                throw_errno("Cannot lock shared memory", name);
+            }
+            if (std::chrono::steady_clock::now() > deadline) {
+                throw std::runtime_error(std::string("Timed out attaching to shared memory '") + name + "'");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return fd;
+    }
+
+    bool same_layout(const Layout& lhs, const Layout& rhs)
+    {
+        return lhs.type_id == rhs.type_id && lhs.size == rhs.size && lhs.alignment == rhs.alignment;
+    }
+
+    static_assert(sizeof(pid_t) <= sizeof(std::int32_t), "Process ids must fit the segment header.");
+
+    bool is_alive(pid_t pid)
+    {
+        return ::kill(pid, 0) == 0 || errno == EPERM;
+    }
+
+    // Claim the construction of a segment whose creator `dead` is gone. Several waiting processes
+    // may notice at once, the compare and swap on the recorded creator elects one of them.
+    bool take_over(Mapping& mapping, std::int32_t dead, const char* name)
+    {
+        if (::mprotect(mapping.base, mapping.size, PROT_READ | PROT_WRITE) != 0) {
+            throw_errno("Cannot take over shared memory", name);
+        }
+        if (header(mapping)->creator.compare_exchange_strong(dead, static_cast<std::int32_t>(::getpid()))) {
+            mapping.creator = true;
+            return true;
+        }
+        ::mprotect(mapping.base, mapping.size, PROT_READ);
+        return false;
+    }
+
+} // end anonymous namespace
+
+
+Mapping open_or_create(const char* name, std::size_t size, const Layout& layout, unsigned timeout_ms)
+{
+    Mapping mapping;
+    mapping.size = size;
+    mapping.layout = layout;
+
+    Descriptor segment{::shm_open(name, O_CREAT | O_RDWR, 0600)};
+    if (segment.fd < 0) {
+        throw_errno("Cannot open shared memory", name);
+    }
+
+    // Segments are sized under this lock, which the system releases if its holder dies, so an
+    // empty segment seen while holding it was abandoned (or just created): its holder creates.
+    Lock lock{lock_before(segment.fd, deadline_after(timeout_ms), name)};
+
+    struct stat info;
+    if (::fstat(segment.fd, &info) != 0) {
+        throw_errno("Cannot stat shared memory", name);
+    }
+
+    if (info.st_size == 0) {
+        if (::ftruncate(segment.fd, static_cast<off_t>(size)) != 0) {
+            throw_errno("Cannot size shared memory", name);
+        }
+        mapping.base = map(segment.fd, size, PROT_READ | PROT_WRITE, name);
+        mapping.creator = true;
+
+        // The zero filled segment already reads as `Initializing`.
+        header(mapping)->creator.store(static_cast<std::int32_t>(::getpid()), std::memory_order_release);
+        return mapping;
+    }
+
+    if (static_cast<std::size_t>(info.st_size) != size) {
+        throw std::runtime_error(std::string("Shared memory '") + name + "' has an unexpected size");
+    }
+
+    // Only the creator writes to the segment.
+    mapping.base = map(segment.fd, size, PROT_READ, name);
+    return mapping;
+}
+
+bool wait_until_ready(Mapping& mapping, const char* name, unsigned timeout_ms)
+{
+    auto deadline = deadline_after(timeout_ms);
+    for (;;) {
+        switch (header(mapping)->state.load(std::memory_order_acquire)) {
+            case SegmentHeader::Ready:
+                if (!same_layout(header(mapping)->layout, mapping.layout)) {
+                    throw std::runtime_error(std::string("Shared memory '") + name + "' holds another type of object");
+                }
+                return true;
+            case SegmentHeader::Failed:
+                throw std::runtime_error(std::string("Creator of shared memory '") + name + "' failed");
+            default:
+                break;
+        }
+        // The state of a dead creator is final, it may have published just before dying.
+        std::int32_t creator = header(mapping)->creator.load(std::memory_order_acquire);
+        if (creator != 0 && !is_alive(creator)
+            && header(mapping)->state.load(std::memory_order_acquire) == SegmentHeader::Initializing
+            && take_over(mapping, creator, name)) {
+            return false;
+        }
+        if (std::chrono::steady_clock::now() > deadline) {
+            throw std::runtime_error(std::string("Timed out waiting for shared memory '") + name + "'");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void publish(const Mapping& mapping, bool success)
+{
+    header(mapping)->layout = mapping.layout;
+    header(mapping)->state.store(
+        success ? SegmentHeader::Ready : SegmentHeader::Failed,
+        std::memory_order_release
+    );
+}
+
+void unmap(Mapping& mapping)
+{
+    if (mapping.base) {
+        ::munmap(mapping.base, mapping.size);
+        mapping.base = nullptr;
+    }
+}
+
+void unlink(const char* name)
+{
+    ::shm_unlink(name);
+}
+
+} // end namespace `shm_internal`
+
+} // end namespace `mosaic`
@@ -5,9 +5,9 @@
 #include "mosaic/utilities/singleton.hpp"
 
 
-namespace lifetime_impl {
+namespace mosaic::lifetime_impl {
 
     TrackerArray pTrackerArray = nullptr;
-    unsigned int elements
+    unsigned int elements = 0;
 
-} // end namespace `lifetime_impl`
\ No newline at end of file
+} // end namespace `mosaic::lifetime_impl`
@@ -0,0 +1,178 @@
+/*! @file singleton_registry.cpp
+ *  @brief Implementation for `SingletonRegistry`.
+ */
+
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <map>
+#include <string>
+#include "mosaic/utilities/singleton_registry.hpp"
+#include "mosaic/utilities/thread_pool.hpp"
+
+namespace mosaic {
+
+SingletonRegistry& SingletonRegistry::instance()
+{
+    static SingletonRegistry s_registry;
+    return s_registry;
+}
+
+void SingletonRegistry::add_node(Key key, PCreationFunction create, std::vector<Key> dependencies)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    nodes_.push_back(Node{key, create, std::move(dependencies)});
+}
+
+void SingletonRegistry::start(std::size_t n_threads)
+{
+    std::vector<Node> nodes;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        nodes = nodes_;
+    }
+
+    const std::size_t n_nodes = nodes.size();
+    if (n_nodes == 0) {
+        return;
+    }
+
+    // Build the dependency graph
+    // --------------------------
+
+    std::map<TypeKey::KeyType, std::size_t> index;
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+        if (!index.emplace(nodes[i].key.type, i).second) {
+            throw std::logic_error(std::string("Singleton registered twice: ") + nodes[i].key.name);
+        }
+    }
+
+    std::vector<std::vector<std::size_t>> dependents(n_nodes);
+    std::vector<std::size_t> pending(n_nodes, 0);
+
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+        for (const auto& dependency : nodes[i].dependencies) {
+            auto found = index.find(dependency.type);
+            if (found == index.end()) {
+                throw std::logic_error(std::string("Unregistered singleton dependency: ") + dependency.name);
+            }
+            dependents[found->second].push_back(i);
+            ++pending[i];
+        }
+    }
+
+    // Reject cycles before creating anything (Kahn's algorithm)
+    // ---------------------------------------------------------
+
+    {
+        std::vector<std::size_t> remaining(pending);
+        std::vector<std::size_t> ready;
+        for (std::size_t i = 0; i < n_nodes; ++i) {
+            if (remaining[i] == 0) {
+                ready.push_back(i);
+            }
+        }
+
+        std::size_t visited = 0;
+        while (!ready.empty()) {
+            std::size_t i = ready.back();
+            ready.pop_back();
+            ++visited;
+            for (std::size_t d : dependents[i]) {
+                if (--remaining[d] == 0) {
+                    ready.push_back(d);
+                }
+            }
+        }
+
+        if (visited != n_nodes) {
+            throw std::logic_error("Singleton dependency cycle detected!");
+        }
+    }
+
+    // Create in parallel, releasing dependents as their dependencies finish
+    // ---------------------------------------------------------------------
+
+    std::mutex run_mutex;
+    std::condition_variable done_cv;
+    std::size_t in_flight = 0;
+    std::exception_ptr error;
+    std::function<void(std::size_t)> launch;
+
+    // Declared last so that it is joined before the state above goes away.
+    ThreadPool pool(n_threads);
+
+    // Must be called with `run_mutex` held.
+    launch = [&](std::size_t i) {
+        ++in_flight;
+        pool.submit([&, i]() {
+            std::exception_ptr failure;
+            try {
+                nodes[i].create();
+            } catch (...) {
+                failure = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> guard(run_mutex);
+            if (failure) {
+                if (!error) {
+                    error = failure;
+                }
+            } else if (!error) {
+                for (std::size_t d : dependents[i]) {
+                    if (--pending[d] == 0) {
+                        launch(d);
+                    }
+                }
+            }
+
+            if (--in_flight == 0) {
+                done_cv.notify_all();
+            }
+        });
+    };
+
+    std::unique_lock<std::mutex> lock(run_mutex);
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+        if (pending[i] == 0) {
+            launch(i);
+        }
+    }
+    done_cv.wait(lock, [&]() { return in_flight == 0; });
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void SingletonRegistry::shutdown()
+{
+    std::vector<PDestructionFunction> destruction_functions;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        destruction_functions.swap(destruction_functions_);
+    }
+
+    for (auto it = destruction_functions.rbegin(); it != destruction_functions.rend(); ++it) {
+        (*it)();
+    }
+}
+
+void SingletonRegistry::schedule_destruction(PDestructionFunction p_destruction_function)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    destruction_functions_.push_back(p_destruction_function);
+
+    if (!at_exit_scheduled_ && this == &instance()) {
+        at_exit_scheduled_ = true;
+        std::atexit(&SingletonRegistry::at_exit);
+    }
+}
+
+void SingletonRegistry::at_exit()
+{
+    instance().shutdown();
+}
+
+} // end namespace `mosaic`
@@ -0,0 +1,170 @@
+/*! @file singleton_trace.cpp
+ *  @brief Implementation for singleton trace `Recorder`.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include "mosaic/utilities/singleton_trace.hpp"
+
+namespace mosaic::trace {
+
+namespace {
+
+    std::uint32_t current_thread_id()
+    {
+        static std::atomic<std::uint32_t> s_next_id{0};
+        thread_local const std::uint32_t t_id = s_next_id.fetch_add(1, std::memory_order_relaxed);
+        return t_id;
+    }
+
+    void write_json_string(std::ostream& os, const char* str)
+    {
+        os << '"';
+        for (; *str; ++str) {
+            switch (*str) {
+                case '"':  os << "\\\""; break;
+                case '\\': os << "\\\\"; break;
+                default:
+                    if (static_cast<unsigned char>(*str) < 0x20) {
+                        os << ' ';
+                    } else {
+                        os << *str;
+                    }
+            }
+        }
+        os << '"';
+    }
+
+    // Never destroyed, it must outlive the static destructors running before the dump.
+    std::string* s_dump_path = nullptr;
+
+    void dump_to_file()
+    {
+        std::ofstream out(*s_dump_path);
+        Recorder::instance().write_chrome_trace(out);
+    }
+
+} // end anonymous namespace
+
+
+const char* to_string(EventKind kind)
+{
+    switch (kind) {
+        case EventKind::Create:  return "create";
+        case EventKind::Destroy: return "destroy";
+        case EventKind::AtExit:  return "atexit";
+    }
+    return "unknown";
+}
+
+
+Recorder& Recorder::instance()
+{
+    static Recorder* s_recorder = new Recorder();
+    return *s_recorder;
+}
+
+Recorder::Recorder() : epoch_(std::chrono::steady_clock::now())
+{
+}
+
+std::uint64_t Recorder::now_ns() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch_
+    ).count();
+}
+
+void Recorder::record(const char* name, EventKind kind, std::uint64_t start_ns, std::uint64_t end_ns)
+{
+    std::uint32_t thread_id = current_thread_id();
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    events_.push_back(Event{
+        name, kind, start_ns, end_ns - start_ns, thread_id, static_cast<std::uint32_t>(events_.size())
+    });
+}
+
+std::vector<Event> Recorder::events() const
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    return events_;
+}
+
+void Recorder::clear()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    events_.clear();
+}
+
+void Recorder::write_chrome_trace(std::ostream& os) const
+{
+    std::vector<Event> events = this->events();
+
+    // Microseconds with nanosecond digits, whatever the magnitude.
+    const std::ios_base::fmtflags flags = os.flags();
+    const std::streamsize precision = os.precision();
+    os << std::fixed << std::setprecision(3);
+
+    os << "{\"traceEvents\":[";
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const Event& e = events[i];
+        os << (i ? ",\n" : "\n") << "{\"name\":";
+        write_json_string(os, e.name);
+        os << ",\"cat\":\"" << to_string(e.kind) << '"'
+           << ",\"ph\":\"X\""
+           << ",\"ts\":" << e.start_ns / 1000.0
+           << ",\"dur\":" << e.duration_ns / 1000.0
+           << ",\"pid\":0"
+           << ",\"tid\":" << e.thread_id
+           << ",\"args\":{\"sequence\":" << e.sequence << "}}";
+    }
+    os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void Recorder::write_table(std::ostream& os) const
+{
+    std::vector<Event> events = this->events();
+
+    const std::ios_base::fmtflags flags = os.flags();
+    const char fill = os.fill(' ');
+    os << std::left
+       << std::setw(5) << "seq" << ' '
+       << std::setw(8) << "kind" << ' '
+       << std::setw(7) << "thread" << ' '
+       << std::setw(14) << "start_ns" << ' '
+       << std::setw(14) << "duration_ns" << ' '
+       << "name\n";
+
+    for (const Event& e : events) {
+        os << std::setw(5) << e.sequence << ' '
+           << std::setw(8) << to_string(e.kind) << ' '
+           << std::setw(7) << e.thread_id << ' '
+           << std::setw(14) << e.start_ns << ' '
+           << std::setw(14) << e.duration_ns << ' '
+           << e.name << '\n';
+    }
+
+    os.flags(flags);
+    os.fill(fill);
+}
+
+void Recorder::dump_at_exit(const char* path)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!s_dump_path) {
+        s_dump_path = new std::string(path);
+        std::atexit(&dump_to_file);
+    } else {
+        *s_dump_path = path;
+    }
+}
+
+} // end namespace `mosaic::trace`
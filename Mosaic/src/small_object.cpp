@@ -0,0 +1,89 @@
+/*! @file small_object.cpp
+ *  @brief Implementation for `FixedAllocator` and `SmallObjAllocator`.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include "mosaic/utilities/small_object.hpp"
+
+namespace mosaic {
+
+FixedAllocator::FixedAllocator(std::size_t block_size, std::size_t slab_size)
+    : block_size_(std::max(block_size, sizeof(FreeBlock))),
+      blocks_per_slab_(std::max<std::size_t>(1, slab_size / block_size_))
+{
+}
+
+FixedAllocator::FixedAllocator(FixedAllocator&& other) noexcept
+    : block_size_(other.block_size_),
+      blocks_per_slab_(other.blocks_per_slab_),
+      free_list_(other.free_list_),
+      carve_ptr_(other.carve_ptr_),
+      carve_end_(other.carve_end_),
+      slabs_(std::move(other.slabs_))
+{
+    other.free_list_ = nullptr;
+    other.carve_ptr_ = other.carve_end_ = nullptr;
+    other.slabs_.clear();
+}
+
+FixedAllocator::~FixedAllocator()
+{
+    for (char* slab : slabs_) {
+        ::operator delete(slab);
+    }
+}
+
+void FixedAllocator::add_slab()
+{
+    assert(carve_ptr_ == carve_end_);
+
+    std::size_t bytes = blocks_per_slab_ * block_size_;
+    if (slabs_.size() == slabs_.capacity()) {
+        slabs_.reserve(std::max<std::size_t>(2 * slabs_.size(), 8));   // Grow before allocating, to keep the new slab if this throws.
+    }
+    char* slab = static_cast<char*>(::operator new(bytes));
+    slabs_.push_back(slab);
+
+    carve_ptr_ = slab;
+    carve_end_ = slab + bytes;
+}
+
+/**************************************************/
+
+SmallObjAllocator::SmallObjAllocator(std::size_t slab_size, std::size_t max_object_size)
+    : max_object_size_(max_object_size)
+{
+    std::size_t n_classes = (max_object_size + granularity - 1) / granularity;
+    pool_.reserve(n_classes);
+    for (std::size_t i = 0; i < n_classes; ++i) {
+        pool_.emplace_back(class_size(i), slab_size);
+    }
+
+    counters_.resize(n_classes + 1);
+}
+
+AllocatorStats SmallObjAllocator::stats() const
+{
+    AllocatorStats stats;
+    stats.bytes_in_use = bytes_in_use_ > 0 ? static_cast<std::size_t>(bytes_in_use_) : 0;
+    stats.peak_bytes = peak_bytes_;
+    stats.cross_thread_frees = cross_thread_frees_;
+
+    for (const FixedAllocator& fixed : pool_) {
+        stats.slab_count += fixed.slab_count();
+        stats.bytes_reserved += fixed.bytes_reserved();
+    }
+
+    stats.size_classes.reserve(counters_.size());
+    for (std::size_t cls = 0; cls < counters_.size(); ++cls) {
+        const ClassCounters& counters = counters_[cls];
+        std::size_t block_size = cls < pool_.size() ? class_size(cls) : 0;
+        std::size_t in_use = counters.allocations > counters.frees ? counters.allocations - counters.frees : 0;
+        stats.size_classes.push_back({block_size, counters.allocations, in_use});
+        stats.allocations += counters.allocations;
+    }
+    return stats;
+}
+
+} // end namespace `mosaic`
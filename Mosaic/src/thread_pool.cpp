@@ -0,0 +1,63 @@
+/*! @file thread_pool.cpp
+ *  @brief Implementation for `ThreadPool`.
+ */
+
+#include <algorithm>
+#include "mosaic/utilities/thread_pool.hpp"
+
+namespace mosaic {
+
+ThreadPool::ThreadPool(std::size_t n_threads)
+{
+    if (n_threads == 0) {
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    workers_.reserve(n_threads);
+    for (std::size_t i = 0; i < n_threads; ++i) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::push(Functor<void> task)
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+void ThreadPool::worker_loop()
+{
+    for (;;) {
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+        if (tasks_.empty()) {   // Only reachable when stopping.
+            return;
+        }
+
+        Functor<void> task(std::move(tasks_.front()));
+        tasks_.pop_front();
+        lock.unlock();
+
+        task();
+    }
+}
+
+} // end namespace `mosaic`
@@ -7,17 +7,18 @@
 
 namespace mosaic {
 
-TypeInfo::TypeInfo(const std::type_info &t_info) : pInfo_(&t_info)
+TypeInfo::TypeInfo(const std::type_info &t_info) : pInfo_(&t_info), hash_(t_info.hash_code())
 {
 }
 
-TypeInfo::TypeInfo(const TypeInfo &t_info) : pInfo_(t_info.pInfo_)
+TypeInfo::TypeInfo(const TypeInfo &t_info) noexcept : pInfo_(t_info.pInfo_), hash_(t_info.hash_)
 {
 }
 
-TypeInfo &TypeInfo::operator=(const TypeInfo &t_info)
+TypeInfo &TypeInfo::operator=(const TypeInfo &t_info) noexcept
 {
     pInfo_ = t_info.pInfo_;
+    hash_ = t_info.hash_;
     return *this;
 }
 
@@ -34,7 +35,10 @@ const char* TypeInfo::name() const
 
 bool operator==(const TypeInfo& lhs, const TypeInfo& rhs)
 {
-    return *(lhs.pInfo_) == *(rhs.pInfo_);
+    // Identical `type_info` objects are the common case. Distinct ones may still describe
+    // the same type across shared libraries, `type_info::operator==` then compares names.
+    return lhs.pInfo_ == rhs.pInfo_
+        || (lhs.hash_ == rhs.hash_ && *(lhs.pInfo_) == *(rhs.pInfo_));
 }
 
 bool operator!=(const TypeInfo& lhs, const TypeInfo& rhs)
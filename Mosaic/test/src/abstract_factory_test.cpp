@@ -0,0 +1,135 @@
+/*! @file abstract_factory_test.cpp
+ *  @brief Tests for `AbstractFactory` and `ConcreteFactory`.
+ */
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/abstract_factory.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    struct Button {
+        virtual ~Button() = default;
+        virtual std::string theme() const = 0;
+    };
+
+    struct Window {
+        virtual ~Window() = default;
+        virtual std::string theme() const = 0;
+    };
+
+    struct Scrollbar {
+        virtual ~Scrollbar() = default;
+        virtual std::string theme() const = 0;
+    };
+
+    struct DarkButton : Button { std::string theme() const override { return "dark"; } };
+    struct DarkWindow : Window { std::string theme() const override { return "dark"; } };
+    struct DarkScrollbar : Scrollbar { std::string theme() const override { return "dark"; } };
+    struct LightButton : Button { std::string theme() const override { return "light"; } };
+    struct LightWindow : Window { std::string theme() const override { return "light"; } };
+    struct LightScrollbar : Scrollbar { std::string theme() const override { return "light"; } };
+
+    using Widgets = MakeTL<Button, Window, Scrollbar>::TL;
+    using WidgetFactory = AbstractFactory<Widgets>;
+
+    using DarkFactory = ConcreteFactory<WidgetFactory, OpNewFactoryUnit, MakeTL<DarkButton, DarkWindow, DarkScrollbar>::TL>;
+    using LightFactory = ConcreteFactory<WidgetFactory, OpNewFactoryUnit, MakeTL<LightButton, LightWindow, LightScrollbar>::TL>;
+
+    using StaticDarkFactory = ConcreteFactory<StaticAbstractFactory<Widgets>, OpNewFactoryUnit, MakeTL<DarkButton, DarkWindow, DarkScrollbar>::TL>;
+
+    std::string themes(WidgetFactory& factory) {
+        std::unique_ptr<Button> button(factory.Create<Button>());
+        std::unique_ptr<Window> window(factory.Create<Window>());
+        std::unique_ptr<Scrollbar> scrollbar(factory.Create<Scrollbar>());
+        return button->theme() + window->theme() + scrollbar->theme();
+    }
+
+} // end anonymous namespace
+
+
+TEST(AbstractFactoryTest, ConcreteFactoriesImplementTheInterface) {
+
+    std::unique_ptr<WidgetFactory> dark = std::make_unique<DarkFactory>();
+    std::unique_ptr<WidgetFactory> light = std::make_unique<LightFactory>();
+
+    EXPECT_EQ(themes(*dark), "darkdarkdark");
+    EXPECT_EQ(themes(*light), "lightlightlight");
+
+    std::unique_ptr<Window> window(dark->Create<Window>());
+    EXPECT_NE(dynamic_cast<DarkWindow*>(window.get()), nullptr);
+
+}
+
+TEST(AbstractFactoryTest, ConcreteCreateReturnsConcreteProducts) {
+
+    LightFactory factory;
+    static_assert(std::is_same_v<decltype(factory.Create<Button>()), LightButton*>);
+
+    std::unique_ptr<LightScrollbar> scrollbar(factory.Create<Scrollbar>());
+    EXPECT_EQ(scrollbar->theme(), "light");
+
+}
+
+TEST(AbstractFactoryTest, StaticFactoryHasNoVirtualDispatch) {
+
+    static_assert(!std::is_polymorphic_v<StaticDarkFactory>);
+    static_assert(std::is_same_v<decltype(StaticDarkFactory().Create<Window>()), DarkWindow*>);
+
+    StaticDarkFactory factory;
+    std::unique_ptr<Button> button(factory.Create<Button>());
+    std::unique_ptr<Window> window(factory.Create<Window>());
+    std::unique_ptr<Scrollbar> scrollbar(factory.Create<Scrollbar>());
+    EXPECT_EQ(button->theme() + window->theme() + scrollbar->theme(), "darkdarkdark");
+
+}
+
+namespace {
+
+    // Expensive to build, cheap to copy.
+    struct ConfiguredButton : Button {
+        explicit ConfiguredButton(std::string t) : theme_(std::move(t)) { ++parses; }
+        ConfiguredButton(const ConfiguredButton&) = default;
+        std::string theme() const override { return theme_; }
+        std::string theme_;
+        static inline int parses = 0;
+    };
+
+    struct ConfiguredWindow : Window {
+        std::string theme() const override { return "configured"; }
+    };
+
+    using PrototypeWidgets = ConcreteFactory<WidgetFactory, PrototypeFactoryUnit>;
+
+} // end anonymous namespace
+
+
+TEST(AbstractFactoryTest, PrototypeUnitsCopyTheirPrototype) {
+
+    PrototypeWidgets factory;
+    EXPECT_EQ(GetPrototype<Button>(factory), nullptr);
+    EXPECT_EQ(factory.Create<Button>(), nullptr);
+
+    SetPrototype<Button>(factory, std::make_unique<ConfiguredButton>("parsed"));
+    SetPrototype<Window>(factory, std::make_unique<ConfiguredWindow>());
+    SetPrototype<Scrollbar>(factory, std::make_unique<DarkScrollbar>());
+
+    WidgetFactory& widgets = factory;
+    std::unique_ptr<Button> a(widgets.Create<Button>());
+    std::unique_ptr<Button> b(widgets.Create<Button>());
+    EXPECT_EQ(a->theme(), "parsed");
+    EXPECT_NE(a.get(), b.get());
+    EXPECT_NE(a.get(), GetPrototype<Button>(factory));
+    EXPECT_EQ(ConfiguredButton::parses, 1);
+    EXPECT_EQ(themes(widgets), "parsedconfigureddark");
+
+    // Swapping a prototype changes the products of the same factory.
+    SetPrototype<Button>(factory, std::make_unique<LightButton>());
+    std::unique_ptr<Button> c(widgets.Create<Button>());
+    EXPECT_NE(dynamic_cast<LightButton*>(c.get()), nullptr);
+
+}
@@ -0,0 +1,179 @@
+/*! @file allocator_stats_test.cpp
+ *  @brief Tests for allocator statistics and the allocation call site `Sampler`.
+ */
+
+#include <memory>
+#include <sstream>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/allocator_stats.hpp"
+#include "mosaic/utilities/arena.hpp"
+#include "mosaic/utilities/object_pool.hpp"
+#include "mosaic/utilities/small_object.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    using Cache = ThreadCache<policies::ClassLevelLockable<SmallObjAllocator>::Lock>;
+
+    struct Sampled : public SmallObject<policies::ClassLevelLockable, 4096, 128> {
+        virtual ~Sampled() = default;
+        long payload[4];
+    };
+
+    [[gnu::noinline]] Sampled* make_sampled() {
+        return new Sampled();
+    }
+
+} // end anonymous namespace
+
+
+TEST(AllocatorStatsTest, SmallObjAllocator) {
+
+    SmallObjAllocator allocator(4096, 64);
+
+    void* a = allocator.allocate(12);
+    void* b = allocator.allocate(16);
+    void* large = allocator.allocate(100);
+
+    AllocatorStats stats = allocator.stats();
+    EXPECT_EQ(stats.bytes_in_use, 32u);     // Both served from the 16 byte class.
+    EXPECT_EQ(stats.allocations, 3u);
+    EXPECT_EQ(stats.slab_count, 1u);
+    EXPECT_GT(stats.bytes_reserved, 0u);
+    EXPECT_GT(stats.fragmentation(), 0.9);
+    EXPECT_EQ(stats.cross_thread_frees, 0u);
+
+    ASSERT_EQ(stats.size_classes.size(), 64 / SmallObjAllocator::granularity + 1);
+    const SizeClassStats& sixteen = stats.size_classes[SmallObjAllocator::size_class(16)];
+    EXPECT_EQ(sixteen.block_size, 16u);
+    EXPECT_EQ(sixteen.allocations, 2u);
+    EXPECT_EQ(sixteen.in_use, 2u);
+    EXPECT_EQ(stats.size_classes.back().block_size, 0u);
+    EXPECT_EQ(stats.size_classes.back().in_use, 1u);
+
+    allocator.deallocate(a, 12);
+    allocator.deallocate(b, 16);
+    allocator.deallocate(large, 100);
+
+    stats = allocator.stats();
+    EXPECT_EQ(stats.bytes_in_use, 0u);
+    EXPECT_EQ(stats.peak_bytes, 32u);
+    EXPECT_EQ(stats.fragmentation(), 1.0);
+
+}
+
+
+TEST(AllocatorStatsTest, ThreadCachesAndCrossThreadFrees) {
+
+    SmallObjAllocator central(4096, 64);
+    bool producer_alive = true, consumer_alive = true;
+    auto producer = std::make_unique<Cache>(central, producer_alive);
+    auto consumer = std::make_unique<Cache>(central, consumer_alive);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 10; ++i) {
+        blocks.push_back(producer->allocate(24));
+    }
+
+    // Reported with the next transfer, or explicitly.
+    EXPECT_EQ(central.stats().allocations, 0u);
+    producer->flush_counters();
+
+    AllocatorStats stats = central.stats();
+    EXPECT_EQ(stats.allocations, 10u);
+    EXPECT_EQ(stats.bytes_in_use, 240u);
+    EXPECT_EQ(stats.peak_bytes, 240u);
+
+    for (void* block : blocks) {
+        consumer->deallocate(block, 24);
+    }
+    consumer->flush_counters();
+
+    stats = central.stats();
+    EXPECT_EQ(stats.bytes_in_use, 0u);
+    EXPECT_EQ(stats.cross_thread_frees, 10u);
+    EXPECT_EQ(stats.size_classes[SmallObjAllocator::size_class(24)].in_use, 0u);
+
+    producer.reset();
+    consumer.reset();
+    stats = central.stats();
+    EXPECT_EQ(stats.allocations, 10u);
+    EXPECT_EQ(stats.cross_thread_frees, 10u);
+
+}
+
+
+TEST(AllocatorStatsTest, ArenaAndPool) {
+
+    MonotonicArena arena(1024);
+    EXPECT_NE(arena.allocate(100, 8), nullptr);
+    EXPECT_NE(arena.allocate(2000, 8), nullptr);
+
+    AllocatorStats arena_stats = arena.stats();
+    EXPECT_EQ(arena_stats.allocations, 2u);
+    EXPECT_EQ(arena_stats.slab_count, 2u);
+    EXPECT_EQ(arena_stats.bytes_in_use, arena.bytes_used());
+    EXPECT_EQ(arena_stats.bytes_reserved, arena.capacity());
+
+    arena.reset();
+    EXPECT_EQ(arena.stats().bytes_in_use, 0u);
+    EXPECT_EQ(arena.stats().peak_bytes, arena_stats.bytes_in_use);
+
+    ObjectPool<long> pool(16);
+    {
+        auto a = pool.acquire(1L);
+        auto b = pool.acquire(2L);
+    }
+    auto c = pool.acquire(3L);
+
+    AllocatorStats pool_stats = pool.stats();
+    EXPECT_EQ(pool_stats.allocations, 3u);
+    EXPECT_EQ(pool_stats.bytes_in_use, sizeof(long));
+    EXPECT_EQ(pool_stats.peak_bytes, 2 * sizeof(long));
+    EXPECT_EQ(pool_stats.slab_count, 1u);
+
+}
+
+
+TEST(AllocatorStatsTest, SamplerRecordsLiveCallSites) {
+
+    auto& sampler = telemetry::Sampler::instance();
+    sampler.start(1);
+
+    std::vector<Sampled*> kept;
+    for (int i = 0; i < 10; ++i) {
+        Sampled* p = make_sampled();
+        if (i % 2) {
+            delete p;
+        } else {
+            kept.push_back(p);
+        }
+    }
+    sampler.stop();
+
+    std::vector<telemetry::CallSite> sites = sampler.live_call_sites();
+    ASSERT_EQ(sites.size(), 1u);
+    EXPECT_EQ(sites[0].allocations, 5u);
+    EXPECT_EQ(sites[0].bytes, 5 * sizeof(Sampled));
+#if MOSAIC_HAS_BACKTRACE
+    EXPECT_NE(sites[0].frames[0], nullptr);
+#endif
+
+    // Samples are dropped when freed, even after stopping.
+    delete kept.back();
+    kept.pop_back();
+    EXPECT_EQ(sampler.live_call_sites()[0].allocations, 4u);
+
+    std::ostringstream report;
+    sampler.write_report(report);
+    EXPECT_NE(report.str().find("4 allocations"), std::string::npos);
+
+    sampler.clear();
+    EXPECT_FALSE(telemetry::Sampler::active());
+    for (Sampled* p : kept) {
+        delete p;
+    }
+
+}
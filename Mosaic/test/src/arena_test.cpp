@@ -0,0 +1,148 @@
+/*! @file arena_test.cpp
+ *  @brief Tests for `MonotonicArena` and memory resource aware `Functor`s.
+ */
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/arena.hpp"
+#include "mosaic/utilities/functor.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    // Counts the chunks taken from the default resource.
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        std::size_t live = 0;
+        std::size_t total = 0;
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            ++live, ++total;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            --live;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    bool is_inside(const void* p, const MonotonicArena& arena) {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        auto begin = reinterpret_cast<std::uintptr_t>(&arena);
+        return address >= begin && address < begin + sizeof(InlineArena<256>);
+    }
+
+    int add(int a, int b) { return a + b; }
+
+} // end anonymous namespace
+
+
+TEST(ArenaTest, BumpAllocationAndAlignment) {
+
+    CountingResource upstream;
+    MonotonicArena arena(1024, &upstream);
+
+    void* a = arena.allocate(1, 1);
+    void* b = arena.allocate(8, 8);
+    void* c = arena.allocate(16, 32);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 8, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c) % 32, 0u);
+    EXPECT_LT(a, b);
+    EXPECT_LT(b, c);
+    EXPECT_EQ(upstream.total, 1u);
+
+    // Larger than a chunk.
+    EXPECT_NE(arena.allocate(10000, 8), nullptr);
+    EXPECT_EQ(upstream.total, 2u);
+    EXPECT_GE(arena.capacity(), 1024u + 10000u);
+
+}
+
+
+TEST(ArenaTest, ResetReusesChunks) {
+
+    CountingResource upstream;
+    MonotonicArena arena(1024, &upstream);
+
+    std::vector<void*> first;
+    for (int i = 0; i < 100; ++i) {
+        first.push_back(arena.allocate(64, 8));
+    }
+    std::size_t used = arena.bytes_used();
+    std::size_t chunks = upstream.total;
+    EXPECT_GE(used, 6400u);
+    EXPECT_EQ(arena.high_water_mark(), used);
+
+    arena.reset();
+    EXPECT_EQ(arena.bytes_used(), 0u);
+    EXPECT_EQ(arena.high_water_mark(), used);
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(arena.allocate(64, 8), first[i]);
+    }
+    EXPECT_EQ(upstream.total, chunks);
+
+    arena.release();
+    EXPECT_EQ(upstream.live, 0u);
+
+}
+
+
+TEST(ArenaTest, InlineStorageFirst) {
+
+    CountingResource upstream;
+    {
+        InlineArena<256> arena(&upstream);
+
+        void* p = arena.allocate(200, 8);
+        EXPECT_TRUE(is_inside(p, arena));
+        EXPECT_EQ(upstream.total, 0u);
+
+        void* q = arena.allocate(200, 8);
+        EXPECT_FALSE(is_inside(q, arena));
+        EXPECT_EQ(upstream.total, 1u);
+
+        arena.reset();
+        EXPECT_EQ(arena.allocate(200, 8), p);
+    }
+    EXPECT_EQ(upstream.live, 0u);
+
+}
+
+
+TEST(ArenaTest, PmrContainers) {
+
+    InlineArena<1024> arena;
+    std::pmr::vector<int> values(&arena);
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+
+    EXPECT_EQ(values[999], 999);
+    EXPECT_GE(arena.high_water_mark(), 1000 * sizeof(int));
+
+}
+
+
+TEST(ArenaTest, FunctorsInArena) {
+
+    MonotonicArena arena;
+    int offset = 10;
+
+    Functor<int, int> fun(std::allocator_arg, &arena, [offset](int i) { return i + offset; });
+    std::size_t used = arena.bytes_used();
+    EXPECT_GT(used, 0u);
+
+    Functor<int, int> copy(fun);
+    EXPECT_GT(arena.bytes_used(), used);       // Clones stay in the arena.
+    EXPECT_EQ(copy(1), 11);
+
+    Functor<int, int, int> function(std::allocator_arg, &arena, add);
+    Functor<int, int> bound = BindFirst(std::allocator_arg, &arena, function, 40);
+    EXPECT_EQ(bound(2), 42);
+
+}
@@ -0,0 +1,256 @@
+/*! @file factory_test.cpp
+ *  @brief Tests for `Factory`.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/factory.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    struct Shape {
+        virtual ~Shape() = default;
+        virtual std::string name() const = 0;
+    };
+
+    struct Circle : Shape {
+        explicit Circle(double r = 1.0) : radius(r) {}
+        std::string name() const override { return "circle"; }
+        double radius;
+    };
+
+    struct Square : Shape {
+        std::string name() const override { return "square"; }
+    };
+
+    Shape* make_circle() { return new Circle; }
+
+    template <typename IdentifierType, class AbstractProduct>
+    struct ReturnNull {
+        static AbstractProduct* OnUnknownType(const IdentifierType&) { return nullptr; }
+    };
+
+} // end anonymous namespace
+
+
+TEST(FactoryTest, CreatesRegisteredTypes) {
+
+    Factory<Shape, std::string> factory;
+    EXPECT_TRUE(factory.Register("circle", make_circle));
+    EXPECT_TRUE(factory.Register("square", [] () -> Shape* { return new Square; }));
+    EXPECT_FALSE(factory.Register("circle", [] () -> Shape* { return new Square; }));
+
+    std::unique_ptr<Shape> circle(factory.CreateObject("circle"));
+    std::unique_ptr<Shape> square(factory.CreateObject("square"));
+    EXPECT_EQ(circle->name(), "circle");
+    EXPECT_EQ(square->name(), "square");
+    EXPECT_EQ(factory.RegisteredIds().size(), 2u);
+
+}
+
+TEST(FactoryTest, UnregisterAndUnknownIds) {
+
+    using ShapeFactory = Factory<Shape, int>;
+    ShapeFactory factory;
+    factory.Register(1, make_circle);
+    EXPECT_TRUE(factory.IsRegistered(1));
+
+    EXPECT_TRUE(factory.Unregister(1));
+    EXPECT_FALSE(factory.Unregister(1));
+    EXPECT_FALSE(factory.IsRegistered(1));
+
+    try {
+        factory.CreateObject(1);
+        FAIL() << "Expected an exception";
+    } catch (const ShapeFactory::Exception& e) {
+        EXPECT_EQ(e.id(), 1);
+    }
+
+    Factory<Shape, int, Functor<Shape*>, ReturnNull> lenient;
+    EXPECT_EQ(lenient.CreateObject(1), nullptr);
+
+}
+
+TEST(FactoryTest, ForwardsCreatorArguments) {
+
+    Factory<Shape, std::string, Functor<Shape*, double>> factory;
+    factory.Register("circle", [] (double r) -> Shape* { return new Circle(r); });
+
+    std::unique_ptr<Shape> shape(factory.CreateObject("circle", 2.5));
+    EXPECT_EQ(static_cast<Circle*>(shape.get())->radius, 2.5);
+
+}
+
+TEST(FactoryTest, CreatesPooledBatches) {
+
+    Factory<Shape, std::string> factory;
+    EXPECT_TRUE(factory.Register<Circle>("circle", 16));
+    EXPECT_FALSE(factory.Register<Square>("circle"));
+    factory.Register("square", [] () -> Shape* { return new Square; });
+
+    std::unique_ptr<Shape> single(factory.CreateObject("circle"));
+    EXPECT_EQ(single->name(), "circle");
+
+    std::uintptr_t first = 0;
+    {
+        auto batch = factory.CreateBatch("circle", 40);
+        ASSERT_EQ(batch.size(), 40u);
+        for (Shape* shape : batch) {
+            EXPECT_EQ(shape->name(), "circle");
+        }
+        // Products of a slab are laid out back to back.
+        const auto stride = reinterpret_cast<std::uintptr_t>(&batch[1]) - reinterpret_cast<std::uintptr_t>(&batch[0]);
+        EXPECT_GE(stride, sizeof(Circle));
+        EXPECT_LT(stride, sizeof(Circle) + alignof(std::max_align_t) + sizeof(void*));
+        first = reinterpret_cast<std::uintptr_t>(&batch[0]);
+
+        auto moved = std::move(batch);
+        EXPECT_TRUE(batch.empty());
+        EXPECT_EQ(moved.size(), 40u);
+    }
+
+    // Released products are reused by the next batch.
+    auto again = factory.CreateBatch("circle", 40);
+    bool reused = false;
+    for (Shape* shape : again) {
+        reused = reused || reinterpret_cast<std::uintptr_t>(shape) == first;
+    }
+    EXPECT_TRUE(reused);
+
+    auto squares = factory.CreateBatch("square", 3);
+    ASSERT_EQ(squares.size(), 3u);
+    EXPECT_EQ(squares[2].name(), "square");
+
+    EXPECT_THROW(factory.CreateBatch("triangle", 3), decltype(factory)::Exception);
+
+}
+
+TEST(StaticFactoryTest, CreatesByDenseId) {
+
+    enum class ShapeId { circle, square };
+    using Shapes = StaticFactory<MakeTL<Circle, Square>::TL, Shape, ShapeId>;
+
+    static_assert(Shapes::size == 2);
+    static_assert(Shapes::IdOf<Square>() == ShapeId::square);
+
+    std::unique_ptr<Shape> circle(Shapes::Create(ShapeId::circle));
+    std::unique_ptr<Shape> square(Shapes::Create(Shapes::IdOf<Square>()));
+    EXPECT_EQ(circle->name(), "circle");
+    EXPECT_EQ(square->name(), "square");
+
+    EXPECT_THROW(Shapes::Create(static_cast<ShapeId>(2)), Shapes::Exception);
+
+}
+
+TEST(StaticFactoryTest, ForwardsArgumentsAndReportsUnknownIds) {
+
+    struct Ellipse : Circle {
+        Ellipse(double r) : Circle(r / 2) {}
+    };
+    using Shapes = StaticFactory<MakeTL<Circle, Ellipse>::TL, Shape, int, ReturnNull>;
+
+    std::unique_ptr<Shape> ellipse(Shapes::Create(1, 3.0));
+    EXPECT_EQ(static_cast<Circle*>(ellipse.get())->radius, 1.5);
+    EXPECT_EQ(Shapes::Create(-1, 1.0), nullptr);
+    EXPECT_EQ(Shapes::Create(2, 1.0), nullptr);
+
+}
+
+TEST(CloneFactoryTest, ClonesAsDynamicType) {
+
+    CloneFactory<Shape> cloner;
+    EXPECT_TRUE(cloner.Register<Circle>());
+    EXPECT_FALSE(cloner.Register<Circle>());
+    EXPECT_TRUE(cloner.IsRegistered(typeid(Circle)));
+
+    Circle circle(4.0);
+    const Shape& model = circle;
+    std::unique_ptr<Shape> copy(cloner.CreateObject(model));
+    ASSERT_NE(dynamic_cast<Circle*>(copy.get()), nullptr);
+    EXPECT_EQ(static_cast<Circle*>(copy.get())->radius, 4.0);
+    EXPECT_NE(copy.get(), &circle);
+
+    EXPECT_EQ(cloner.CreateObject(nullptr), nullptr);
+
+}
+
+TEST(CloneFactoryTest, UnregisteredTypes) {
+
+    using ShapeCloner = CloneFactory<Shape>;
+    ShapeCloner cloner;
+    cloner.Register(typeid(Square), [] (const Shape&) -> Shape* { return new Square; });
+
+    Circle circle;
+    try {
+        cloner.CreateObject(circle);
+        FAIL() << "Expected an exception";
+    } catch (const ShapeCloner::Exception& e) {
+        EXPECT_EQ(e.id(), TypeInfo(typeid(Circle)));
+    }
+
+    Square square;
+    std::unique_ptr<Shape> copy(cloner.CreateObject(square));
+    EXPECT_EQ(copy->name(), "square");
+    EXPECT_TRUE(cloner.Unregister(typeid(Square)));
+    EXPECT_THROW(cloner.CreateObject(square), ShapeCloner::Exception);
+
+}
+
+TEST(ConcurrentFactoryTest, RegistersWhileCreating) {
+
+    using ShapeFactory = ConcurrentFactory<Shape, int>;
+    ShapeFactory factory;
+    EXPECT_TRUE(factory.Register(0, make_circle));
+    EXPECT_FALSE(factory.Register(0, make_circle));
+
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> creators;
+    for (int t = 0; t < 4; ++t) {
+        creators.emplace_back([&, t] {
+            for (int i = 0; !done.load(std::memory_order_relaxed); ++i) {
+                const int id = (i + t) % 8;
+                try {
+                    std::unique_ptr<Shape> shape(factory.CreateObject(id));
+                    if (shape->name() != (id == 0 || id % 2 ? "circle" : "square")) {
+                        ++failures;
+                    }
+                } catch (const ShapeFactory::Exception&) {
+                    if (id == 0) {
+                        ++failures;
+                    }
+                }
+            }
+        });
+    }
+
+    for (int round = 0; round < 50; ++round) {
+        for (int id = 1; id < 8; ++id) {
+            if (id % 2) {
+                factory.Register(id, make_circle);
+            } else {
+                factory.Register(id, [] () -> Shape* { return new Square; });
+            }
+        }
+        EXPECT_EQ(factory.RegisteredIds().size(), 8u);
+        for (int id = 1; id < 8; ++id) {
+            EXPECT_TRUE(factory.Unregister(id));
+        }
+    }
+    done = true;
+    for (auto& creator : creators) {
+        creator.join();
+    }
+
+    EXPECT_EQ(failures, 0);
+    EXPECT_TRUE(factory.IsRegistered(0));
+    EXPECT_FALSE(factory.IsRegistered(1));
+
+}
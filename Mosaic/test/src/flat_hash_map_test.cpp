@@ -0,0 +1,134 @@
+/*! @file flat_hash_map_test.cpp
+ *  @brief Tests for `FlatHashMap`.
+ */
+
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/flat_hash_map.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    // Every key lands on the same home slot.
+    struct CollidingHash {
+        std::size_t operator()(int) const noexcept { return 42; }
+    };
+
+} // end anonymous namespace
+
+
+TEST(FlatHashMapTest, InsertFindErase) {
+
+    FlatHashMap<std::string, int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find("one"), nullptr);
+
+    EXPECT_TRUE(map.emplace("one", 1));
+    EXPECT_TRUE(map.emplace("two", 2));
+    EXPECT_FALSE(map.emplace("one", 10));
+
+    ASSERT_NE(map.find("one"), nullptr);
+    EXPECT_EQ(*map.find("one"), 1);
+    EXPECT_EQ(*map.find("two"), 2);
+    EXPECT_EQ(map.size(), 2u);
+
+    EXPECT_TRUE(map.erase("one"));
+    EXPECT_FALSE(map.erase("one"));
+    EXPECT_FALSE(map.contains("one"));
+    EXPECT_TRUE(map.contains("two"));
+    EXPECT_EQ(map.size(), 1u);
+
+}
+
+TEST(FlatHashMapTest, GrowsAndReserves) {
+
+    FlatHashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(map.emplace(i * 1024, i));
+    }
+    EXPECT_EQ(map.size(), 1000u);
+    EXPECT_LE(map.size() * 4, map.capacity() * 3);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_NE(map.find(i * 1024), nullptr);
+        EXPECT_EQ(*map.find(i * 1024), i);
+    }
+
+    FlatHashMap<int, int> reserved(100);
+    const std::size_t capacity = reserved.capacity();
+    for (int i = 0; i < 100; ++i) {
+        reserved.emplace(i, i);
+    }
+    EXPECT_EQ(reserved.capacity(), capacity);
+
+}
+
+TEST(FlatHashMapTest, EraseKeepsCollidingKeysReachable) {
+
+    FlatHashMap<int, int, CollidingHash> map;
+    for (int i = 0; i < 5; ++i) {
+        map.emplace(i, i);
+    }
+    EXPECT_TRUE(map.erase(0));
+    EXPECT_TRUE(map.erase(2));
+    for (int i : {1, 3, 4}) {
+        ASSERT_NE(map.find(i), nullptr);
+        EXPECT_EQ(*map.find(i), i);
+    }
+    EXPECT_EQ(map.find(2), nullptr);
+
+}
+
+TEST(FlatHashMapTest, MatchesUnorderedMapUnderChurn) {
+
+    FlatHashMap<int, int> map;
+    std::unordered_map<int, int> reference;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> key(0, 300);
+
+    for (int i = 0; i < 20000; ++i) {
+        const int k = key(rng);
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(map.erase(k), reference.erase(k) == 1);
+        } else {
+            EXPECT_EQ(map.emplace(k, i), reference.emplace(k, i).second);
+        }
+    }
+    ASSERT_EQ(map.size(), reference.size());
+    for (int k = 0; k <= 300; ++k) {
+        const int* value = map.find(k);
+        auto it = reference.find(k);
+        ASSERT_EQ(value != nullptr, it != reference.end());
+        if (value) {
+            EXPECT_EQ(*value, it->second);
+        }
+    }
+
+    std::size_t visited = 0;
+    map.for_each([&](int k, int v) { ++visited; EXPECT_EQ(reference.at(k), v); });
+    EXPECT_EQ(visited, reference.size());
+
+}
+
+TEST(FlatHashMapTest, DestroysValues) {
+
+    auto counter = std::make_shared<int>(0);
+    {
+        FlatHashMap<int, std::shared_ptr<int>> map;
+        for (int i = 0; i < 50; ++i) {
+            map.emplace(i, counter);
+        }
+        map.erase(3);
+        EXPECT_EQ(counter.use_count(), 50);
+
+        FlatHashMap<int, std::shared_ptr<int>> moved(std::move(map));
+        EXPECT_TRUE(map.empty());
+        EXPECT_EQ(moved.size(), 49u);
+        EXPECT_EQ(counter.use_count(), 50);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+
+}
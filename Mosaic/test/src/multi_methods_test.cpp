@@ -0,0 +1,139 @@
+/*! @file multi_methods_test.cpp
+ *  @brief Tests for `StaticDispatcher`, `BasicDispatcher` and `FnDispatcher`.
+ */
+
+#include <memory>
+#include <string>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/multi_methods.hpp"
+#include "mosaic/utilities/visitor.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    struct Asteroid;
+    struct Ship;
+    struct Station;
+
+    using Bodies = MakeTL<Asteroid, Ship, Station>::TL;
+
+    struct Body : DenseVisitableBase<Bodies> {
+        virtual ~Body() = default;
+    };
+
+    struct Asteroid : DenseVisitable<Asteroid, Body> {};
+    struct Ship : DenseVisitable<Ship, Body> {};
+    struct Station : DenseVisitable<Station, Body> {};
+
+    // Keeps the type index of `Ship`.
+    struct Cruiser : Ship {};
+
+    struct Collide {
+        std::string Fire(Asteroid&, Asteroid&) { return "asteroid-asteroid"; }
+        std::string Fire(Asteroid&, Ship&) { return "asteroid-ship"; }
+        std::string Fire(Asteroid&, Cruiser&) { return "asteroid-cruiser"; }
+        std::string Fire(Ship&, Ship&) { return "ship-ship"; }
+        std::string Fire(Ship&, Cruiser&) { return "ship-cruiser"; }
+        std::string Fire(Cruiser&, Cruiser&) { return "cruiser-cruiser"; }
+        std::string Fire(Body&, Body&) { return "other"; }
+        std::string OnError(Body&, Body&) { return "error"; }
+    };
+
+    using Physical = MakeTL<Asteroid, Ship, Cruiser>::TL;
+
+    std::string bounce(Asteroid&, Asteroid&) { return "bounce"; }
+    std::string dock(Ship&, Station&) { return "dock"; }
+    std::string crash(Asteroid&, Ship&) { return "crash"; }
+
+} // end anonymous namespace
+
+
+TEST(StaticDispatcherTest, FiresOnMostDerivedTypes) {
+
+    using Dispatcher = StaticDispatcher<Collide, Body, Physical, false, Body, Physical, std::string>;
+    Collide collide;
+    Asteroid asteroid;
+    Ship ship;
+    Cruiser cruiser;
+    Station station;
+
+    EXPECT_EQ(Dispatcher::Go(asteroid, ship, collide), "asteroid-ship");
+    EXPECT_EQ(Dispatcher::Go(asteroid, cruiser, collide), "asteroid-cruiser");
+    EXPECT_EQ(Dispatcher::Go(cruiser, cruiser, collide), "cruiser-cruiser");
+    // Not symmetric, `Fire(Ship&, Asteroid&)` resolves to the `Body` overload.
+    EXPECT_EQ(Dispatcher::Go(ship, asteroid, collide), "other");
+    EXPECT_EQ(Dispatcher::Go(station, ship, collide), "error");
+    EXPECT_EQ(Dispatcher::Go(ship, station, collide), "error");
+
+}
+
+TEST(StaticDispatcherTest, SymmetricSwapsArguments) {
+
+    using Dispatcher = StaticDispatcher<Collide, Body, Physical, true, Body, Physical, std::string>;
+    Collide collide;
+    Asteroid asteroid;
+    Ship ship;
+    Cruiser cruiser;
+
+    EXPECT_EQ(Dispatcher::Go(ship, asteroid, collide), "asteroid-ship");
+    EXPECT_EQ(Dispatcher::Go(cruiser, ship, collide), "ship-cruiser");
+    EXPECT_EQ(Dispatcher::Go(cruiser, asteroid, collide), "asteroid-cruiser");
+
+}
+
+TEST(BasicDispatcherTest, DispatchesOnExactDynamicTypes) {
+
+    using Error = policies::DefaultDispatcherError<Body, Body, std::string>::Exception;
+    BasicDispatcher<Body, Body, std::string> dispatcher;
+    dispatcher.Add<Asteroid, Asteroid>([](Body&, Body&) { return std::string("bounce"); });
+    dispatcher.Add<Ship, Station>([](Body&, Body&) { return std::string("dock"); });
+
+    Asteroid asteroid;
+    Ship ship;
+    Cruiser cruiser;
+    Station station;
+    Body& a = asteroid;
+    Body& s = ship;
+
+    EXPECT_EQ(dispatcher.Go(a, a), "bounce");
+    EXPECT_EQ(dispatcher.Go(s, station), "dock");
+    EXPECT_THROW(dispatcher.Go(station, s), Error);
+    EXPECT_THROW(dispatcher.Go(cruiser, station), Error);
+
+    dispatcher.Add(typeid(Ship), typeid(Station), [](Body&, Body&) { return std::string("moor"); });
+    EXPECT_EQ(dispatcher.Go(s, station), "moor");
+
+    EXPECT_TRUE((dispatcher.Remove<Ship, Station>()));
+    EXPECT_FALSE((dispatcher.Remove<Ship, Station>()));
+    EXPECT_THROW(dispatcher.Go(s, station), Error);
+
+}
+
+TEST(FnDispatcherTest, DispatchesOnTypeIndices) {
+
+    FnDispatcher<Body, Body, std::string> dispatcher;
+    dispatcher.Add<&bounce>();
+    dispatcher.Add<&dock>();
+    dispatcher.Add<&crash, true>();
+
+    Asteroid asteroid;
+    Ship ship;
+    Cruiser cruiser;
+    Station station;
+
+    EXPECT_EQ(dispatcher.Go(asteroid, asteroid), "bounce");
+    EXPECT_EQ(dispatcher.Go(ship, station), "dock");
+    // Type indices, so a `Cruiser` is a `Ship`.
+    EXPECT_EQ(dispatcher.Go(cruiser, station), "dock");
+    EXPECT_EQ(dispatcher.Go(asteroid, ship), "crash");
+    EXPECT_EQ(dispatcher.Go(ship, asteroid), "crash");
+
+    using Error = policies::DefaultDispatcherError<Body, Body, std::string>::Exception;
+    EXPECT_THROW(dispatcher.Go(station, ship), Error);
+
+    dispatcher.Remove<Asteroid, Ship, true>();
+    EXPECT_THROW(dispatcher.Go(asteroid, ship), Error);
+    EXPECT_THROW(dispatcher.Go(ship, asteroid), Error);
+
+}
@@ -0,0 +1,108 @@
+/*! @file no_rtti_test.cpp
+ *  @brief Tests for the components keyed on `TypeId`, built with `-fno-rtti`.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/factory.hpp"
+#include "mosaic/utilities/multi_methods.hpp"
+#include "mosaic/utilities/singleton.hpp"
+#include "mosaic/utilities/singleton_registry.hpp"
+#include "mosaic/utilities/threading.hpp"
+#include "mosaic/utilities/type_id.hpp"
+
+using namespace mosaic;
+
+static_assert(!MOSAIC_HAS_RTTI, "Build this test without RTTI!");
+static_assert(std::is_same_v<policies::DefaultTypeKey, policies::TypeIdKey>);
+
+namespace no_rtti {
+
+    struct Animal {
+        virtual ~Animal() = default;
+        virtual std::uint64_t type_id() const = 0;
+        virtual std::string name() const = 0;
+    };
+
+    struct Cat : Animal {
+        MOSAIC_OVERRIDE_TYPE_ID(Cat)
+        std::string name() const override { return "cat"; }
+    };
+
+    struct Dog : Animal {
+        MOSAIC_OVERRIDE_TYPE_ID(Dog)
+        std::string name() const override { return "dog"; }
+    };
+
+    struct Zoo {
+        int visitors = 0;
+    };
+
+    using ZooHolder = SingletonHolder<Zoo, policies::CreateUsingNew, policies::DefaultLifetime, policies::ClassLevelLockable>;
+
+    struct Keeper {
+        Keeper() : zoo(&ZooHolder::instance()) {}
+        Zoo* zoo;
+    };
+
+    using KeeperHolder = SingletonHolder<Keeper, policies::CreateUsingNew, policies::DefaultLifetime, policies::ClassLevelLockable>;
+
+} // end namespace `no_rtti`
+
+using namespace no_rtti;
+
+
+TEST(NoRttiTest, SingletonHolder) {
+
+    ++ZooHolder::instance().visitors;
+    EXPECT_EQ(&ZooHolder::instance(), &ZooHolder::instance());
+    EXPECT_GE(ZooHolder::instance().visitors, 1);
+
+    SingletonRegistry registry;
+    registry.add<KeeperHolder, MakeTL<ZooHolder>::TL>();
+    registry.add<ZooHolder>();
+    registry.start(2);
+    EXPECT_EQ(KeeperHolder::instance().zoo, &ZooHolder::instance());
+
+}
+
+TEST(NoRttiTest, Factory) {
+
+    Factory<Animal, std::uint64_t> factory;
+    factory.Register(TypeId<Cat>(), [] () -> Animal* { return new Cat; });
+    const std::unique_ptr<Animal> created(factory.CreateObject(TypeId<Cat>()));
+    EXPECT_EQ(created->name(), "cat");
+    EXPECT_EQ(created->type_id(), TypeId<Cat>());
+
+}
+
+TEST(NoRttiTest, CloneFactory) {
+
+    CloneFactory<Animal, Animal* (*)(const Animal&), policies::DefaultFactoryError, policies::TypeIdKey> cloner;
+    EXPECT_TRUE(cloner.Register<Dog>());
+    const std::unique_ptr<Animal> original = std::make_unique<Dog>();
+    const std::unique_ptr<Animal> copy(cloner.CreateObject(*original));
+    EXPECT_EQ(copy->name(), "dog");
+    using UnknownType = policies::DefaultFactoryError<std::uint64_t, Animal>::Exception;
+    EXPECT_THROW(cloner.CreateObject(Cat()), UnknownType);
+
+}
+
+TEST(NoRttiTest, BasicDispatcher) {
+
+    using Dispatcher = BasicDispatcher<
+        Animal, Animal, std::string, std::string (*)(Animal&, Animal&),
+        policies::DefaultDispatcherError<Animal, Animal, std::string>, policies::TypeIdKey
+    >;
+    Dispatcher dispatcher;
+    dispatcher.Add<Dog, Cat>([](Animal& lhs, Animal& rhs) { return lhs.name() + " chases " + rhs.name(); });
+    Dog dog;
+    Cat cat;
+    EXPECT_EQ(dispatcher.Go(dog, cat), "dog chases cat");
+    using UnknownTypes = policies::DefaultDispatcherError<Animal, Animal, std::string>::Exception;
+    EXPECT_THROW(dispatcher.Go(cat, dog), UnknownTypes);
+
+}
@@ -0,0 +1,125 @@
+/*! @file object_pool_test.cpp
+ *  @brief Tests for `ObjectPool`.
+ */
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/arena.hpp"
+#include "mosaic/utilities/object_pool.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    struct Tracked {
+        explicit Tracked(int v = 0) : value(v) { ++alive; }
+        ~Tracked() { --alive; }
+        int value;
+        static inline int alive = 0;
+    };
+
+    struct Throwing {
+        Throwing() { throw std::runtime_error("construction failed"); }
+    };
+
+    struct Request {
+        std::vector<char> body;
+        std::string path;
+    };
+
+    struct ClearRequest {
+        void operator()(Request& request) const {
+            request.body.clear();
+            request.path.clear();
+        }
+    };
+
+} // end anonymous namespace
+
+
+TEST(ObjectPoolTest, HandlesReturnObjects) {
+
+    {
+        ObjectPool<Tracked> pool(4);
+
+        auto a = pool.acquire(1);
+        Tracked* address = a.get();
+        EXPECT_EQ(a->value, 1);
+        EXPECT_EQ(Tracked::alive, 1);
+        EXPECT_EQ(pool.in_use(), 1u);
+
+        a.reset();
+        EXPECT_EQ(Tracked::alive, 0);
+        EXPECT_EQ(pool.available(), 1u);
+
+        auto b = pool.acquire(2);
+        EXPECT_EQ(b.get(), address);
+        EXPECT_EQ(b->value, 2);
+    }
+    EXPECT_EQ(Tracked::alive, 0);
+
+}
+
+
+TEST(ObjectPoolTest, ContiguousSlabs) {
+
+    ObjectPool<Tracked> pool(8);
+
+    std::vector<ObjectPool<Tracked>::Handle> handles;
+    for (int i = 0; i < 20; ++i) {
+        handles.push_back(pool.acquire(i));
+    }
+    EXPECT_EQ(pool.slab_count(), 3u);
+    EXPECT_EQ(pool.capacity(), 24u);
+
+    // Slots within a slab are adjacent.
+    auto distance = reinterpret_cast<char*>(handles[1].get()) - reinterpret_cast<char*>(handles[0].get());
+    for (int i = 1; i < 8; ++i) {
+        EXPECT_EQ(reinterpret_cast<char*>(handles[i].get()) - reinterpret_cast<char*>(handles[i - 1].get()), distance);
+    }
+
+}
+
+
+TEST(ObjectPoolTest, ConstructorFailureKeepsSlot) {
+
+    ObjectPool<Throwing> pool(4);
+
+    EXPECT_THROW(pool.acquire(), std::runtime_error);
+    EXPECT_EQ(pool.in_use(), 0u);
+    EXPECT_EQ(pool.available(), 1u);
+
+}
+
+
+TEST(ObjectPoolTest, ResetHookKeepsBuffers) {
+
+    ObjectPool<Request, ClearRequest> pool;
+
+    auto request = pool.acquire();
+    request->body.resize(4096);
+    request->path = "/a/rather/long/path/that/does/not/fit/in/small/string/storage";
+    const char* body = request->body.data();
+    request.reset();
+
+    auto reused = pool.acquire();
+    EXPECT_TRUE(reused->body.empty());
+    EXPECT_TRUE(reused->path.empty());
+    EXPECT_GE(reused->body.capacity(), 4096u);
+    EXPECT_EQ(reused->body.data(), body);
+
+}
+
+
+TEST(ObjectPoolTest, SlabsFromArena) {
+
+    MonotonicArena arena;
+    ObjectPool<Tracked> pool(16, &arena);
+
+    auto handle = pool.acquire(7);
+    EXPECT_GE(arena.bytes_used(), 16 * sizeof(Tracked));
+    EXPECT_EQ(handle->value, 7);
+
+}
@@ -0,0 +1,254 @@
+/*! @file parallel_visitor_test.cpp
+ *  @brief Tests for `ParallelVisitAll()`.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/parallel_visitor.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    struct Circle;
+    struct Square;
+
+    struct Shape : DenseVisitableBase<MakeTL<Circle, Square>::TL> {
+        explicit Shape(int id) : id(id) {}
+        virtual ~Shape() = default;
+        int id;
+    };
+
+    struct Circle : DenseVisitable<Circle, Shape> {
+        using DenseVisitable::DenseVisitable;
+    };
+
+    struct Square : DenseVisitable<Square, Shape> {
+        using DenseVisitable::DenseVisitable;
+    };
+
+    struct CountShapes {
+        void Visit(const Circle&) { ++circles; }
+        void Visit(const Square&) { ++squares; }
+        int circles = 0;
+        int squares = 0;
+    };
+
+    struct ListShapes {
+        static constexpr VisitOrder visit_order = VisitOrder::preserve;
+        void Visit(const Shape& s) { ids.push_back(s.id); }
+        std::vector<int> ids;
+    };
+
+    struct CountCopies {
+        CountCopies() = default;
+        CountCopies(const CountCopies& other) : visits(other.visits) { ++copies; }
+        CountCopies(CountCopies&&) = default;
+        CountCopies& operator=(const CountCopies&) = default;
+        void Visit(const Shape&) { ++visits; }
+        int visits = 0;
+        static inline int copies = 0;
+    };
+
+    struct ThrowOnSquare {
+        void Visit(const Circle&) {}
+        void Visit(const Square&) { throw std::runtime_error("square"); }
+    };
+
+    std::vector<std::unique_ptr<Shape>> make_shapes(int n) {
+        std::vector<std::unique_ptr<Shape>> shapes;
+        for (int i = 0; i < n; ++i) {
+            if (i % 3 == 0) {
+                shapes.push_back(std::make_unique<Square>(i));
+            } else {
+                shapes.push_back(std::make_unique<Circle>(i));
+            }
+        }
+        return shapes;
+    }
+
+    class Leaf;
+    class Node;
+    using TreeVisitor = CyclicVisitor<void, MakeTL<Leaf, Node>::TL>;
+
+    struct Tree {
+        virtual ~Tree() = default;
+        virtual void Accept(TreeVisitor&) = 0;
+    };
+
+    class Leaf : public Tree { public: MOSAIC_DEFINE_CYCLIC_VISITABLE(TreeVisitor) };
+    class Node : public Tree { public: MOSAIC_DEFINE_CYCLIC_VISITABLE(TreeVisitor) };
+
+    struct CountTrees : TreeVisitor {
+        void Visit(Leaf&) override { ++leaves; }
+        void Visit(Node&) override { ++nodes; }
+        int leaves = 0;
+        int nodes = 0;
+    };
+
+    struct SlowCountTrees : TreeVisitor {
+        void Visit(Leaf&) override { slow_visit(); }
+        void Visit(Node&) override { slow_visit(); }
+        void slow_visit() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++visits;
+            ++total_visits;
+        }
+        int visits = 0;
+        static inline std::atomic<int> total_visits{0};
+    };
+
+    // Random access iterator whose copies on the `armed` thread throw once `copies_left` runs out.
+    struct ThrowingIterator {
+
+        using Base = std::vector<std::unique_ptr<Tree>>::const_iterator;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::unique_ptr<Tree>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        explicit ThrowingIterator(Base it) : it(it) {}
+        ThrowingIterator(const ThrowingIterator& other) : it(other.it) {
+            if (std::this_thread::get_id() == armed && copies_left-- == 0) {
+                throw std::runtime_error("iterator copy");
+            }
+        }
+        ThrowingIterator& operator=(const ThrowingIterator&) = default;
+
+        reference operator*() const { return *it; }
+        ThrowingIterator& operator++() { ++it; return *this; }
+        ThrowingIterator operator+(difference_type n) const { return ThrowingIterator(it + n); }
+        difference_type operator-(const ThrowingIterator& other) const { return it - other.it; }
+        bool operator!=(const ThrowingIterator& other) const { return it != other.it; }
+
+        Base it;
+        static inline std::thread::id armed;
+        static inline int copies_left = 0;
+    };
+
+    struct ThrowingRange {
+        ThrowingIterator begin() const { return ThrowingIterator(trees.begin()); }
+        ThrowingIterator end() const { return ThrowingIterator(trees.end()); }
+        const std::vector<std::unique_ptr<Tree>>& trees;
+    };
+
+} // end anonymous namespace
+
+
+TEST(ParallelVisitorTest, MergesVisitorCopies) {
+
+    ThreadPool pool(3);
+    const auto shapes = make_shapes(10000);
+
+    const CountShapes count = ParallelVisitAll(pool, shapes, CountShapes(), [](CountShapes& into, const CountShapes& part) {
+        into.circles += part.circles;
+        into.squares += part.squares;
+    });
+    EXPECT_EQ(count.circles, 6666);
+    EXPECT_EQ(count.squares, 3334);
+
+    // More chunks than elements.
+    const CountShapes few = ParallelVisitAll(pool, make_shapes(2), CountShapes(), [](CountShapes& into, const CountShapes& part) {
+        into.circles += part.circles;
+        into.squares += part.squares;
+    }, 16);
+    EXPECT_EQ(few.circles, 1);
+    EXPECT_EQ(few.squares, 1);
+
+}
+
+TEST(ParallelVisitorTest, MergesInChunkOrder) {
+
+    ThreadPool pool(4);
+    const auto shapes = make_shapes(1000);
+
+    const ListShapes list = ParallelVisitAll(pool, shapes, ListShapes(), [](ListShapes& into, const ListShapes& part) {
+        into.ids.insert(into.ids.end(), part.ids.begin(), part.ids.end());
+    }, 7);
+    ASSERT_EQ(list.ids.size(), shapes.size());
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(list.ids[i], i);
+    }
+
+    const ListShapes empty = ParallelVisitAll(pool, std::vector<Shape*>(), ListShapes(), [](ListShapes&, const ListShapes&) {
+        ADD_FAILURE() << "Nothing to merge";
+    });
+    EXPECT_TRUE(empty.ids.empty());
+
+}
+
+TEST(ParallelVisitorTest, OneCopyPerChunkOnItsOwnCacheLine) {
+
+    ThreadPool pool(2);
+    const auto shapes = make_shapes(10);
+
+    // Chunks of 2 elements: only 5 of the 8 requested chunks exist.
+    int merged = 0;
+    CountCopies::copies = 0;
+    const CountCopies count = ParallelVisitAll(pool, shapes, CountCopies(), [&merged](CountCopies& into, const CountCopies& part) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&part) % 64, 0u);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&into) % 64, 0u);
+        into.visits += part.visits;
+        ++merged;
+    }, 8);
+    EXPECT_EQ(count.visits, 10);
+    EXPECT_EQ(merged, 4);
+    EXPECT_LE(CountCopies::copies, 5 + 1);  // The chunks' copies, and the prototype they are copied from.
+
+}
+
+
+TEST(ParallelVisitorTest, AcceptsCyclicVisitors) {
+
+    ThreadPool pool(2);
+    std::vector<std::unique_ptr<Tree>> trees;
+    for (int i = 0; i < 500; ++i) {
+        trees.push_back(i % 5 ? std::unique_ptr<Tree>(std::make_unique<Leaf>()) : std::make_unique<Node>());
+    }
+
+    const CountTrees count = ParallelVisitAll(pool, trees, CountTrees(), [](CountTrees& into, const CountTrees& part) {
+        into.leaves += part.leaves;
+        into.nodes += part.nodes;
+    });
+    EXPECT_EQ(count.leaves, 400);
+    EXPECT_EQ(count.nodes, 100);
+
+}
+
+TEST(ParallelVisitorTest, RethrowsAfterEveryChunk) {
+
+    ThreadPool pool(2);
+    const auto shapes = make_shapes(100);
+    EXPECT_THROW(ParallelVisitAll(pool, shapes, ThrowOnSquare(), [](ThrowOnSquare&, const ThrowOnSquare&) {}), std::runtime_error);
+
+}
+
+TEST(ParallelVisitorTest, WaitsForSubmittedChunksWhenSubmittingThrows) {
+
+    ThreadPool pool(2);
+    std::vector<std::unique_ptr<Tree>> trees;
+    for (int i = 0; i < 80; ++i) {
+        trees.push_back(std::make_unique<Leaf>());
+    }
+
+    // Throws on the calling thread after a few chunks are submitted, never on the workers.
+    ThrowingIterator::armed = std::this_thread::get_id();
+    ThrowingIterator::copies_left = 10;
+    EXPECT_THROW(ParallelVisitAll(pool, ThrowingRange{trees}, SlowCountTrees(), [](SlowCountTrees&, const SlowCountTrees&) {}, 8), std::runtime_error);
+    ThrowingIterator::armed = std::thread::id();
+
+    // Nothing keeps visiting the copies destroyed with the call.
+    const int visits = SlowCountTrees::total_visits;
+    EXPECT_GT(visits, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(SlowCountTrees::total_visits, visits);
+
+}
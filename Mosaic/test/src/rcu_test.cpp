@@ -0,0 +1,80 @@
+/*! @file rcu_test.cpp
+ *  @brief Tests for `RcuCell`.
+ *  @note Most useful when built with `-DMOSAIC_SANITIZE_THREAD=ON`.
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/rcu.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    // Snapshot whose fields must always agree, and which detects use after deletion.
+    struct Snapshot {
+        explicit Snapshot(int v = 0) : value(v), copy(v) { ++alive; }
+        ~Snapshot() { value = copy = -1; --alive; }
+        int value;
+        int copy;
+        static inline std::atomic<int> alive{0};
+    };
+
+} // end anonymous namespace
+
+
+TEST(RcuCellTest, ReadAndUpdate) {
+
+    {
+        RcuCell<Snapshot> cell(std::make_unique<Snapshot>(1));
+        EXPECT_EQ(cell.read([](const Snapshot& s) { return s.value; }), 1);
+
+        cell.update([](const Snapshot& s) { return std::make_unique<Snapshot>(s.value + 1); });
+        EXPECT_EQ(cell.read([](const Snapshot& s) { return s.value; }), 2);
+        EXPECT_EQ(Snapshot::alive, 1);
+
+        cell.update([](const Snapshot&) { return std::unique_ptr<Snapshot>(); });
+        EXPECT_EQ(cell.read([](const Snapshot& s) { return s.value; }), 2);
+    }
+    EXPECT_EQ(Snapshot::alive, 0);
+
+}
+
+TEST(RcuCellTest, ReadersNeverSeeDeletedSnapshots) {
+
+    RcuCell<Snapshot> cell;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            int last = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                cell.read([&](const Snapshot& s) {
+                    std::this_thread::yield();
+                    if (s.value != s.copy || s.value < last) {
+                        ++torn;
+                    }
+                    last = s.value;
+                });
+            }
+        });
+    }
+
+    for (int v = 1; v <= 500; ++v) {
+        cell.update([v](const Snapshot&) { return std::make_unique<Snapshot>(v); });
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(torn, 0);
+    EXPECT_EQ(cell.read([](const Snapshot& s) { return s.value; }), 500);
+    EXPECT_EQ(Snapshot::alive, 1);
+
+}
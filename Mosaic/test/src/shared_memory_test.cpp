@@ -0,0 +1,243 @@
+/*! @file shared_memory_test.cpp
+ *  @brief Tests for `CreateInSharedMemory` and `OffsetPtr`.
+ */
+
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/shared_memory.hpp"
+#include "mosaic/utilities/singleton.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    struct Node {
+        int value;
+        OffsetPtr<Node> next;
+    };
+
+    struct LookupTable {
+
+        explicit LookupTable(SharedMemoryArena& arena)
+            : creator_pid(::getpid()), size(1000), entries(arena.construct_array<int>(size))
+        {
+            for (int i = 0; i < size; ++i) {
+                entries[i] = i * i;
+            }
+        }
+
+        pid_t creator_pid;
+        int size;
+        OffsetPtr<int> entries;
+
+        static const char* shared_memory_name() {
+            static const std::string s_name = "/mosaic_test_table." + std::to_string(::getpid());
+            return s_name.c_str();
+        }
+    };
+
+    // Kills its process halfway through construction when `crash` is set.
+    struct CrashingTable : LookupTable {
+
+        explicit CrashingTable(SharedMemoryArena& arena) : LookupTable(arena) {
+            if (crash) {
+                ::_exit(3);
+            }
+        }
+
+        static inline bool crash = false;
+
+        static const char* shared_memory_name() {
+            static const std::string s_name = "/mosaic_test_crashing." + std::to_string(::getpid());
+            return s_name.c_str();
+        }
+    };
+
+    // Same size and alignment, other types: one build of a program after another.
+    const char* layout_test_name() {
+        static const std::string s_name = "/mosaic_test_layout." + std::to_string(::getpid());
+        return s_name.c_str();
+    }
+
+    struct Genuine {
+        int value = 1;
+        static const char* shared_memory_name() { return layout_test_name(); }
+    };
+
+    struct Impostor {
+        float value = 1.0f;
+        static const char* shared_memory_name() { return layout_test_name(); }
+    };
+
+    struct Unsized {
+        int value = 7;
+        static const char* shared_memory_name() {
+            static const std::string s_name = "/mosaic_test_unsized." + std::to_string(::getpid());
+            return s_name.c_str();
+        }
+    };
+
+    using Table = policies::CreateInSharedMemory<const LookupTable>;
+    using TableHolder = SingletonHolder<const LookupTable, policies::CreateInSharedMemory>;
+    using CrashingTableHolder = SingletonHolder<const CrashingTable, policies::CreateInSharedMemory>;
+
+} // end anonymous namespace
+
+template <>
+struct mosaic::SharedMemoryTraits<LookupTable> {
+    static const char* name() { return LookupTable::shared_memory_name(); }
+    static constexpr std::size_t arena_size = 1000 * sizeof(int);
+    static constexpr unsigned attach_timeout_ms = 5000;
+};
+
+template <>
+struct mosaic::SharedMemoryTraits<CrashingTable> {
+    static const char* name() { return CrashingTable::shared_memory_name(); }
+    static constexpr std::size_t arena_size = 1000 * sizeof(int);
+    static constexpr unsigned attach_timeout_ms = 5000;
+};
+
+
+TEST(SharedMemoryTest, OffsetPtrSurvivesRelocation) {
+
+    alignas(Node) unsigned char first[2 * sizeof(Node)];
+    alignas(Node) unsigned char second[2 * sizeof(Node)];
+
+    Node* nodes = reinterpret_cast<Node*>(first);
+    new (&nodes[1]) Node{2, nullptr};
+    new (&nodes[0]) Node{1, &nodes[1]};
+
+    EXPECT_EQ(nodes[0].next->value, 2);
+    EXPECT_FALSE(nodes[1].next);
+
+    // A bitwise copy of the whole region keeps internal links valid.
+    std::memcpy(second, first, sizeof(first));
+    Node* moved = reinterpret_cast<Node*>(second);
+    EXPECT_EQ(moved[0].next.get(), &moved[1]);
+    EXPECT_EQ(moved[0].next->value, 2);
+
+}
+
+
+TEST(SharedMemoryTest, ArenaExhaustion) {
+
+    alignas(std::max_align_t) char buffer[64];
+    SharedMemoryArena arena(buffer, sizeof(buffer));
+
+    EXPECT_NE(arena.allocate(40), nullptr);
+    EXPECT_THROW(arena.allocate(40), std::bad_alloc);
+    EXPECT_EQ(arena.used(), 40u);
+
+}
+
+
+TEST(SharedMemoryTest, SecondProcessAttaches) {
+
+    Table::unlink();
+
+    // The child is forked before the segment exists, so it must attach rather than inherit it.
+    int to_child[2];
+    ASSERT_EQ(::pipe(to_child), 0);
+
+    pid_t parent = ::getpid();
+    pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+
+    if (child == 0) {
+        char go;
+        if (::read(to_child[0], &go, 1) != 1) {
+            ::_exit(10);
+        }
+        const LookupTable& table = TableHolder::instance();
+        bool ok = !Table::is_creator()
+            && table.creator_pid == parent
+            && table.entries[999] == 999 * 999;
+        ::_exit(ok ? 0 : 1);
+    }
+
+    const LookupTable& table = TableHolder::instance();
+    EXPECT_TRUE(Table::is_creator());
+    EXPECT_EQ(table.entries[10], 100);
+
+    ASSERT_EQ(::write(to_child[1], "g", 1), 1);
+
+    int status = 0;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    ::close(to_child[0]);
+    ::close(to_child[1]);
+    Table::unlink();
+
+}
+
+
+TEST(SharedMemoryTest, TakesOverFromDeadCreator) {
+
+    using CrashingSegment = policies::CreateInSharedMemory<const CrashingTable>;
+    CrashingSegment::unlink();
+
+    // The child creates the segment and dies before publishing the object.
+    pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        CrashingTable::crash = true;
+        CrashingTableHolder::instance();
+        ::_exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 3);
+
+    const CrashingTable& table = CrashingTableHolder::instance();
+    EXPECT_TRUE(CrashingSegment::is_creator());
+    EXPECT_EQ(table.creator_pid, ::getpid());
+    EXPECT_EQ(table.entries[999], 999 * 999);
+
+    CrashingSegment::unlink();
+
+}
+
+
+TEST(SharedMemoryTest, RejectsAnotherLayout) {
+
+    using GenuineSegment = policies::CreateInSharedMemory<const Genuine>;
+    using ImpostorSegment = policies::CreateInSharedMemory<const Impostor>;
+    GenuineSegment::unlink();
+
+    const Genuine* genuine = GenuineSegment::create();
+    ASSERT_TRUE(GenuineSegment::is_creator());
+    EXPECT_THROW(ImpostorSegment::create(), std::runtime_error);
+
+    GenuineSegment::destroy(genuine);
+    GenuineSegment::unlink();
+
+}
+
+
+TEST(SharedMemoryTest, CreatesAbandonedEmptySegment) {
+
+    using UnsizedSegment = policies::CreateInSharedMemory<const Unsized>;
+    UnsizedSegment::unlink();
+
+    // What a creator dying between `shm_open()` and `ftruncate()` leaves behind.
+    int fd = ::shm_open(Unsized::shared_memory_name(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+
+    const Unsized* unsized = UnsizedSegment::create();
+    EXPECT_TRUE(UnsizedSegment::is_creator());
+    EXPECT_EQ(unsized->value, 7);
+
+    UnsizedSegment::destroy(unsized);
+    UnsizedSegment::unlink();
+
+}
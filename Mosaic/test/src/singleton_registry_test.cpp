@@ -0,0 +1,196 @@
+/*! @file singleton_registry_test.cpp
+ *  @brief Tests for `SingletonRegistry`.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/singleton.hpp"
+#include "mosaic/utilities/singleton_registry.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    std::mutex log_mutex;
+    std::vector<std::string> created_log;
+    std::vector<std::string> destroyed_log;
+
+    void log(std::vector<std::string>& events, const std::string& name) {
+        std::lock_guard<std::mutex> guard(log_mutex);
+        events.push_back(name);
+    }
+
+    std::size_t position(const std::vector<std::string>& events, const std::string& name) {
+        return std::find(events.begin(), events.end(), name) - events.begin();
+    }
+
+    template <int id>
+    struct Logged {
+        Logged() { log(created_log, name()); }
+        ~Logged() { log(destroyed_log, name()); }
+        static std::string name() { return "S" + std::to_string(id); }
+    };
+
+    template <int id>
+    using LoggedHolder = SingletonHolder<Logged<id>, policies::CreateUsingNew, policies::RegistryLifetime, policies::ClassLevelLockable>;
+
+    // Both constructors wait for each other, so they only both succeed if run in parallel.
+    std::atomic<int> rendezvous_count{0};
+    std::atomic<bool> overlapped{true};
+
+    template <int id>
+    struct Rendezvous {
+        Rendezvous() {
+            ++rendezvous_count;
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (rendezvous_count.load() < 2) {
+                if (std::chrono::steady_clock::now() > deadline) {
+                    overlapped = false;
+                    return;
+                }
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    template <int id>
+    using RendezvousHolder = SingletonHolder<Rendezvous<id>, policies::CreateUsingNew, policies::RegistryLifetime, policies::ClassLevelLockable>;
+
+    template <char tag>
+    struct Announced {
+        ~Announced() { std::fprintf(stderr, "%c ", tag); }
+    };
+
+    using AnnouncedHolder = SingletonHolder<Announced<'R'>, policies::CreateUsingNew, policies::RegistryLifetime>;
+
+    struct Unused {};
+    using UnusedHolder = SingletonHolder<Unused, policies::CreateUsingNew, policies::DefaultLifetime, policies::ClassLevelLockable>;
+
+    struct Throwing {
+        Throwing() { throw std::runtime_error("construction failed"); }
+    };
+    using ThrowingHolder = SingletonHolder<Throwing, policies::CreateUsingNew, policies::DefaultLifetime, policies::ClassLevelLockable>;
+
+} // end anonymous namespace
+
+
+TEST(SingletonRegistryTest, DependencyOrderedStartupAndShutdown) {
+
+    // S4 -> S3 -> {S1, S2}
+    SingletonRegistry registry;
+    registry.add<LoggedHolder<4>, MakeTL<LoggedHolder<3>>::TL>();
+    registry.add<LoggedHolder<3>, MakeTL<LoggedHolder<1>, LoggedHolder<2>>::TL>();
+    registry.add<LoggedHolder<2>>();
+    registry.add<LoggedHolder<1>>();
+
+    registry.start(4);
+
+    ASSERT_EQ(created_log.size(), 4u);
+    EXPECT_LT(position(created_log, "S1"), position(created_log, "S3"));
+    EXPECT_LT(position(created_log, "S2"), position(created_log, "S3"));
+    EXPECT_LT(position(created_log, "S3"), position(created_log, "S4"));
+
+    SingletonRegistry::instance().shutdown();
+
+    ASSERT_EQ(destroyed_log.size(), 4u);
+    EXPECT_LT(position(destroyed_log, "S4"), position(destroyed_log, "S3"));
+    EXPECT_LT(position(destroyed_log, "S3"), position(destroyed_log, "S1"));
+    EXPECT_LT(position(destroyed_log, "S3"), position(destroyed_log, "S2"));
+
+}
+
+
+TEST(SingletonRegistryTest, IndependentSingletonsCreatedInParallel) {
+
+    SingletonRegistry registry;
+    registry.add<RendezvousHolder<1>>();
+    registry.add<RendezvousHolder<2>>();
+
+    registry.start(2);
+
+    EXPECT_EQ(rendezvous_count.load(), 2);
+    EXPECT_TRUE(overlapped.load());
+
+}
+
+
+TEST(SingletonRegistryTest, RejectsCycles) {
+
+    SingletonRegistry registry;
+    registry.add<UnusedHolder, MakeTL<ThrowingHolder>::TL>();
+    registry.add<ThrowingHolder, MakeTL<UnusedHolder>::TL>();
+
+    // Validation happens before anything is created.
+    EXPECT_THROW(registry.start(1), std::logic_error);
+
+}
+
+
+TEST(SingletonRegistryTest, RejectsUnregisteredDependency) {
+
+    SingletonRegistry registry;
+    registry.add<UnusedHolder, MakeTL<ThrowingHolder>::TL>();
+
+    EXPECT_THROW(registry.start(1), std::logic_error);
+
+}
+
+
+TEST(SingletonRegistryTest, PropagatesConstructorFailure) {
+
+    SingletonRegistry registry;
+    registry.add<ThrowingHolder>();
+
+    EXPECT_THROW(registry.start(1), std::runtime_error);
+
+}
+
+
+TEST(SingletonRegistryTest, ChecksHolderPolicies) {
+
+    // Rejected by `add()`.
+    static_assert(registry_internal::IsSingleThreaded<SingletonHolder<Unused>>::value);
+    static_assert(!registry_internal::AllHaveRegistryLifetime<MakeTL<LoggedHolder<1>, UnusedHolder>::TL>::value);
+
+    static_assert(!registry_internal::IsSingleThreaded<UnusedHolder>::value);
+    static_assert(registry_internal::AllHaveRegistryLifetime<MakeTL<LoggedHolder<1>, LoggedHolder<2>>::TL>::value);
+
+}
+
+
+TEST(SingletonRegistryTest, InterleavesWithSetLongevityAtExit) {
+
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+    // Tracked before the first registry singleton exists: destroyed after the registry.
+    EXPECT_EXIT(
+        {
+            SetLongevity(new Announced<'A'>(), 1, &lifetime_impl::Deleter<Announced<'A'>>::Delete);
+            AnnouncedHolder::instance();
+            std::exit(0);
+        },
+        ::testing::ExitedWithCode(0),
+        "R A"
+    );
+
+    // Tracked after: destroyed before the registry.
+    EXPECT_EXIT(
+        {
+            AnnouncedHolder::instance();
+            SetLongevity(new Announced<'B'>(), 1, &lifetime_impl::Deleter<Announced<'B'>>::Delete);
+            std::exit(0);
+        },
+        ::testing::ExitedWithCode(0),
+        "B R"
+    );
+
+}
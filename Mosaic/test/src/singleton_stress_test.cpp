@@ -0,0 +1,182 @@
+/*! @file singleton_stress_test.cpp
+ *  @brief Multi-threaded stress tests for `SingletonHolder`.
+ *  @note Most useful when built with `-DMOSAIC_SANITIZE_THREAD=ON`.
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/singleton.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    constexpr int n_threads = 8;
+    constexpr int n_calls = 2000;
+    constexpr int n_rounds = 50;
+
+    /*! Lifetime policy that lets the test destroy the singleton, and choose
+     *  between throwing on dead reference and recreating the object.
+     */
+    template <class T>
+    struct ControlledLifetime {
+        using PDestructionFunction = void (*)();
+        static inline PDestructionFunction destroy = nullptr;
+        static inline std::atomic<bool> allow_phoenix{false};
+
+        static void schedule_destruction(PDestructionFunction p_destruction_function) {
+            destroy = p_destruction_function;
+        }
+        static void on_dead_reference() {
+            if (!allow_phoenix) {
+                throw std::runtime_error("Reuse of dead singleton detected!");
+            }
+        }
+    };
+
+    template <int id>
+    struct Counted {
+        Counted() : value(42) { ++constructed; }
+        ~Counted() { value = 0; ++destroyed; }
+
+        int value;
+
+        static inline std::atomic<int> constructed{0};
+        static inline std::atomic<int> destroyed{0};
+    };
+
+    // Calls `fun` on `n_threads` threads released together.
+    template <class Fun>
+    void hammer(Fun fun) {
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < n_threads; ++i) {
+            threads.emplace_back([&go, &fun]() {
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                fun();
+            });
+        }
+        go.store(true, std::memory_order_release);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+} // end anonymous namespace
+
+
+TEST(SingletonStressTest, FirstUseRaceCreatesOnce) {
+
+    using Object = Counted<1>;
+    using Holder = SingletonHolder<Object, policies::CreateUsingNew, ControlledLifetime, policies::ClassLevelLockable>;
+    ControlledLifetime<Object>::allow_phoenix = true;
+
+    for (int round = 0; round < n_rounds; ++round) {
+
+        std::atomic<Object*> seen{nullptr};
+        std::atomic<int> mismatches{0};
+
+        hammer([&]() {
+            for (int i = 0; i < n_calls; ++i) {
+                Object& obj = Holder::instance();
+                Object* expected = nullptr;
+                if (!seen.compare_exchange_strong(expected, &obj) && expected != &obj) {
+                    ++mismatches;
+                }
+                if (obj.value != 42) {
+                    ++mismatches;
+                }
+            }
+        });
+
+        EXPECT_EQ(mismatches.load(), 0);
+        EXPECT_EQ(Object::constructed.load(), round + 1);
+
+        // Destroy so that the next round races on creation again.
+        ControlledLifetime<Object>::destroy();
+        EXPECT_EQ(Object::destroyed.load(), round + 1);
+    }
+
+}
+
+
+TEST(SingletonStressTest, DeadReferenceThrowsOnEveryThread) {
+
+    using Object = Counted<2>;
+    using Holder = SingletonHolder<Object, policies::CreateUsingNew, ControlledLifetime, policies::ClassLevelLockable>;
+
+    Holder::instance();
+    ControlledLifetime<Object>::destroy();
+
+    std::atomic<int> thrown{0};
+    hammer([&]() {
+        for (int i = 0; i < n_calls / 10; ++i) {
+            try {
+                Holder::instance();
+            } catch (const std::runtime_error&) {
+                ++thrown;
+            }
+        }
+    });
+
+    EXPECT_EQ(thrown.load(), n_threads * (n_calls / 10));
+    EXPECT_EQ(Object::constructed.load(), 1);
+
+}
+
+
+TEST(SingletonStressTest, PhoenixRecreatedOnceUnderContention) {
+
+    using Object = Counted<3>;
+    using Holder = SingletonHolder<Object, policies::CreateUsingNew, ControlledLifetime, policies::ClassLevelLockable>;
+
+    Holder::instance();
+    ControlledLifetime<Object>::destroy();
+    ControlledLifetime<Object>::allow_phoenix = true;
+
+    std::atomic<int> bad_values{0};
+    hammer([&]() {
+        for (int i = 0; i < n_calls; ++i) {
+            if (Holder::instance().value != 42) {
+                ++bad_values;
+            }
+        }
+    });
+
+    EXPECT_EQ(bad_values.load(), 0);
+    EXPECT_EQ(Object::constructed.load(), 2);
+    EXPECT_EQ(Object::destroyed.load(), 1);
+
+    ControlledLifetime<Object>::destroy();
+
+}
+
+
+TEST(SingletonStressTest, SingleThreadPolicyHotPathIsRaceFree) {
+
+    // `SingleThread` does not lock creation, but reading an existing instance is safe.
+    using Object = Counted<4>;
+    using Holder = SingletonHolder<Object, policies::CreateUsingNew, ControlledLifetime, policies::SingleThread>;
+
+    Object* created = &Holder::instance();
+
+    std::atomic<int> mismatches{0};
+    hammer([&]() {
+        for (int i = 0; i < n_calls; ++i) {
+            if (&Holder::instance() != created) {
+                ++mismatches;
+            }
+        }
+    });
+
+    EXPECT_EQ(mismatches.load(), 0);
+    EXPECT_EQ(Object::constructed.load(), 1);
+
+    ControlledLifetime<Object>::destroy();
+
+}
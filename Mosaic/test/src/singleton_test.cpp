@@ -0,0 +1,143 @@
+/*! @file singleton_test.cpp
+ *  @brief Tests for `SingletonHolder` policies.
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/singleton.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    std::atomic<bool> table_gate{false};
+
+    struct SlowTable {
+        SlowTable() : builder(std::this_thread::get_id()) {
+            while (!table_gate.load()) {
+                std::this_thread::yield();
+            }
+        }
+        std::thread::id builder;
+    };
+
+    using SlowTableHolder = SingletonHolder<SlowTable, policies::CreateInBackground, policies::DefaultLifetime, policies::ClassLevelLockable>;
+
+    struct BrokenTable {
+        BrokenTable() { throw std::runtime_error("load failed"); }
+    };
+
+    using BrokenTableHolder = SingletonHolder<BrokenTable, policies::CreateInBackground>;
+
+    struct EarlyTable {
+        EarlyTable() { ++constructions; }
+        static inline std::atomic<int> constructions{0};
+    };
+
+    using EarlyTableHolder = SingletonHolder<EarlyTable, policies::CreateInBackground>;
+
+    // Launched during static initialization, possibly before the policy's own statics.
+    StartInBackground<EarlyTableHolder> start_early_table;
+
+    struct Logger {
+        Logger() { std::fprintf(stderr, "created "); }
+        ~Logger() { std::fprintf(stderr, "destroyed "); }
+    };
+
+    using PhoenixLogger = SingletonHolder<Logger, policies::CreateUsingNew, policies::PhoenixSingleton>;
+
+    void log_after_destruction() {
+        PhoenixLogger::instance();
+    }
+
+    struct Sink {
+        ~Sink() { destroyed = true; }
+        static inline bool destroyed = false;
+    };
+
+    using ImmortalSink = SingletonHolder<Sink, policies::CreateUsingNew, policies::NoDestroy>;
+
+    void check_sink_alive() {
+        ImmortalSink::instance();
+        std::_Exit(Sink::destroyed ? 1 : 0);
+    }
+
+} // end anonymous namespace
+
+
+TEST(SingletonTest, CreateInBackground) {
+
+    StartInBackground<SlowTableHolder> start;
+
+    EXPECT_FALSE(SlowTableHolder::Creator::ready());
+
+    table_gate = true;
+    SlowTable& table = SlowTableHolder::instance();     // Blocks until built.
+
+    EXPECT_TRUE(SlowTableHolder::Creator::ready());
+    EXPECT_NE(table.builder, std::this_thread::get_id());
+    EXPECT_EQ(&SlowTableHolder::instance(), &table);
+
+}
+
+
+TEST(SingletonTest, CreateInBackgroundFailure) {
+
+    BrokenTableHolder::Creator::launch();
+
+    EXPECT_THROW(BrokenTableHolder::instance(), std::runtime_error);
+    EXPECT_FALSE(BrokenTableHolder::Creator::ready());
+    EXPECT_THROW(BrokenTableHolder::instance(), std::runtime_error);
+
+}
+
+
+TEST(SingletonTest, CreateInBackgroundDuringStaticInitialization) {
+
+    EarlyTableHolder::instance();
+
+    EXPECT_TRUE(EarlyTableHolder::Creator::ready());
+    EXPECT_EQ(EarlyTable::constructions.load(), 1);
+
+}
+
+
+TEST(SingletonTest, PhoenixSingletonRecreatedAfterDestruction) {
+
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+    // `log_after_destruction` is registered first, so it runs after the logger is destroyed.
+    EXPECT_EXIT(
+        {
+            std::atexit(&log_after_destruction);
+            PhoenixLogger::instance();
+            std::exit(0);
+        },
+        ::testing::ExitedWithCode(0),
+        "^created destroyed created destroyed $"
+    );
+
+}
+
+
+TEST(SingletonTest, NoDestroyNeverDestroys) {
+
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+    EXPECT_EXIT(
+        {
+            std::atexit(&check_sink_alive);
+            ImmortalSink::instance();
+            std::exit(0);
+        },
+        ::testing::ExitedWithCode(0),
+        ""
+    );
+
+    EXPECT_EQ(&ImmortalSink::instance(), &ImmortalSink::instance());
+
+}
@@ -0,0 +1,173 @@
+/*! @file singleton_trace_test.cpp
+ *  @brief Tests for singleton creation/destruction tracing.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/singleton.hpp"
+#include "mosaic/utilities/singleton_trace.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    // Lifetime policy that lets the test trigger destruction.
+    template <class T>
+    struct ManualLifetime {
+        using PDestructionFunction = void (*)();
+        static inline PDestructionFunction destroy = nullptr;
+
+        static void schedule_destruction(PDestructionFunction p_destruction_function) {
+            destroy = p_destruction_function;
+        }
+        static void on_dead_reference() {
+            throw std::runtime_error("Reuse of dead singleton detected!");
+        }
+    };
+
+    struct Traced {};
+    using TracedHolder = SingletonHolder<Traced, policies::CreateUsingNew, ManualLifetime>;
+
+    struct TracedAtExit {};
+    struct TracedLongevity {};
+
+    void print_table() {
+        trace::Recorder::instance().write_table(std::cerr);
+    }
+
+} // end anonymous namespace
+
+
+TEST(SingletonTraceTest, ExportFormats) {
+
+    auto& recorder = trace::Recorder::instance();
+    recorder.clear();
+
+    {
+        trace::ScopedEvent event("Some\"Type", trace::EventKind::Create);
+    }
+
+    auto events = recorder.events();
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].kind, trace::EventKind::Create);
+    EXPECT_EQ(events[0].sequence, 0u);
+
+    std::ostringstream json;
+    recorder.write_chrome_trace(json);
+    EXPECT_NE(json.str().find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"name\":\"Some\\\"Type\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"ph\":\"X\""), std::string::npos);
+
+    std::ostringstream table;
+    table << std::right << std::setfill('*');
+    recorder.write_table(table);
+    EXPECT_NE(table.str().find("create"), std::string::npos);
+    EXPECT_NE(table.str().find("Some\"Type"), std::string::npos);
+    EXPECT_EQ(table.str().find('*'), std::string::npos);
+
+    // The stream's formatting is restored.
+    EXPECT_TRUE(table.flags() & std::ios_base::right);
+    EXPECT_EQ(table.fill(), '*');
+
+    // Late events keep their sub-microsecond digits.
+    recorder.clear();
+    recorder.record("Late", trace::EventKind::Destroy, 1234567891, 1234569391);
+    std::ostringstream late;
+    recorder.write_chrome_trace(late);
+    EXPECT_NE(late.str().find("\"ts\":1234567.891,\"dur\":1.500"), std::string::npos) << late.str();
+
+}
+
+
+TEST(SingletonTraceTest, HolderRecordsCreateAndDestroy) {
+
+#ifndef MOSAIC_SINGLETON_TRACE
+    GTEST_SKIP() << "Built without MOSAIC_SINGLETON_TRACE";
+#endif
+
+    auto& recorder = trace::Recorder::instance();
+    recorder.clear();
+
+    TracedHolder::instance();
+    TracedHolder::instance();   // Hot path, no event.
+    ManualLifetime<Traced>::destroy();
+
+    auto events = recorder.events();
+    ASSERT_EQ(events.size(), 2u);
+
+    EXPECT_EQ(events[0].kind, trace::EventKind::Create);
+    EXPECT_STREQ(events[0].name, typeid(Traced).name());
+
+    EXPECT_EQ(events[1].kind, trace::EventKind::Destroy);
+    EXPECT_STREQ(events[1].name, typeid(Traced).name());
+    EXPECT_LT(events[0].sequence, events[1].sequence);
+    EXPECT_LE(events[0].start_ns + events[0].duration_ns, events[1].start_ns);
+
+}
+
+
+TEST(SingletonTraceTest, RecordsShutdownOrder) {
+
+#ifndef MOSAIC_SINGLETON_TRACE
+    GTEST_SKIP() << "Built without MOSAIC_SINGLETON_TRACE";
+#endif
+
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+    std::string holder_name = typeid(TracedAtExit).name();
+    std::string longevity_name = typeid(TracedLongevity).name();
+
+    // Destruction at exit: `SetLongevity` (registered last) runs first, the table last.
+    EXPECT_EXIT(
+        {
+            trace::Recorder::instance().clear();
+            std::atexit(&print_table);
+            SingletonHolder<TracedAtExit>::instance();
+            SetLongevity(new TracedLongevity(), 1, &lifetime_impl::Deleter<TracedLongevity>::Delete);
+            std::exit(0);
+        },
+        ::testing::ExitedWithCode(0),
+        "atexit +[0-9]+ +[0-9]+ +[0-9]+ +" + longevity_name +
+        "[[:space:]]+[0-9]+ +destroy +[0-9]+ +[0-9]+ +[0-9]+ +" + holder_name
+    );
+
+}
+
+
+TEST(SingletonTraceTest, DumpsAtExitToACopyOfThePath) {
+
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+    const std::string path = ::testing::TempDir() + "mosaic_dump_at_exit.json";
+    std::remove(path.c_str());
+
+    // The caller's buffer is gone by the time the dump runs.
+    EXPECT_EXIT(
+        {
+            trace::Recorder::instance().clear();
+            std::string scratch = path;
+            trace::Recorder::instance().dump_at_exit(scratch.c_str());
+            scratch.assign(scratch.size(), 'x');
+            trace::Recorder::instance().record("Dumped", trace::EventKind::Create, 1000, 2000);
+            std::exit(0);
+        },
+        ::testing::ExitedWithCode(0),
+        ""
+    );
+
+    std::ifstream in(path);
+    ASSERT_TRUE(in.is_open()) << path;
+    std::stringstream content;
+    content << in.rdbuf();
+    EXPECT_NE(content.str().find("\"name\":\"Dumped\""), std::string::npos) << content.str();
+    std::remove(path.c_str());
+
+}
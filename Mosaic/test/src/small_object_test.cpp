@@ -0,0 +1,220 @@
+/*! @file small_object_test.cpp
+ *  @brief Tests for the small-object allocator.
+ */
+
+#include <cstdint>
+#include <set>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/functor.hpp"
+#include "mosaic/utilities/small_object.hpp"
+#include "mosaic/utilities/thread_pool.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    struct Base : public SmallObject<> {
+        virtual ~Base() = default;
+    };
+
+    template <std::size_t n>
+    struct Derived : public Base {
+        char payload[n];
+    };
+
+    struct alignas(16) Aligned : public SmallObject<> {
+        long double value;
+    };
+
+    struct alignas(64) OverAligned : public SmallObject<> {
+        virtual ~OverAligned() = default;
+        char value;
+    };
+
+    struct alignas(64) AlignedIncrement {
+        int operator()(int i) const { return i + offset; }
+        int offset = 1;
+    };
+
+    using CachedObject = SmallObject<policies::ClassLevelLockable, 4096, 64>;
+
+    struct Message : public CachedObject {
+        virtual ~Message() = default;
+        long payload[3];
+    };
+
+    using Cache = ThreadCache<policies::ClassLevelLockable<SmallObjAllocator>::Lock>;
+
+} // end anonymous namespace
+
+
+TEST(SmallObjectTest, FixedAllocatorReusesFreedBlocks) {
+
+    FixedAllocator allocator(24, 24 * 4);
+
+    std::set<void*> blocks;
+    for (int i = 0; i < 10; ++i) {
+        blocks.insert(allocator.allocate());
+    }
+    EXPECT_EQ(blocks.size(), 10u);
+    EXPECT_EQ(allocator.slab_count(), 3u);
+
+    void* p = *blocks.begin();
+    allocator.deallocate(p);
+    EXPECT_EQ(allocator.allocate(), p);
+    EXPECT_EQ(allocator.slab_count(), 3u);
+
+}
+
+
+TEST(SmallObjectTest, SizeClassesAndLargeFallback) {
+
+    SmallObjAllocator allocator(4096, 64);
+
+    std::vector<std::pair<void*, std::size_t>> allocations;
+    for (std::size_t size : {1, 8, 9, 16, 63, 64, 65, 1000}) {
+        void* p = allocator.allocate(size);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % alignof(void*), 0u);
+        allocations.emplace_back(p, size);
+    }
+    for (auto [p, size] : allocations) {
+        allocator.deallocate(p, size);
+    }
+
+    // Same size class, most recently freed block first.
+    void* a = allocator.allocate(10);
+    allocator.deallocate(a, 10);
+    EXPECT_EQ(allocator.allocate(16), a);
+
+}
+
+
+TEST(SmallObjectTest, DerivedNewDeleteThroughBase) {
+
+    std::vector<Base*> objects;
+    for (int i = 0; i < 1000; ++i) {
+        objects.push_back(i % 2 ? static_cast<Base*>(new Derived<8>()) : new Derived<100>());
+    }
+    for (Base* p : objects) {
+        delete p;
+    }
+
+    Base* freed = new Derived<8>();
+    auto freed_address = reinterpret_cast<std::uintptr_t>(freed);
+    delete freed;
+    Base* reused = new Derived<8>();
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(reused), freed_address);    // Sized delete returned it to the right class.
+    delete reused;
+
+    Aligned* aligned = new Aligned();
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % alignof(Aligned), 0u);
+    delete aligned;
+
+}
+
+
+TEST(SmallObjectTest, FunctorHandlersUseSmallObjects) {
+
+    const AllocatorStats before = SmallObject<>::stats();
+    const auto fun = Functor<int, int>([](int i) { return i + 1; });
+    auto copy = fun;
+    const AllocatorStats after = SmallObject<>::stats();
+
+    EXPECT_EQ(copy(1), 2);
+    // The handler and its clone.
+    EXPECT_EQ(after.allocations - before.allocations, 2u);
+    EXPECT_GE(after.bytes_in_use - before.bytes_in_use, 2 * sizeof(fun_internal::FunctorImpl<int, int>));
+
+}
+
+
+TEST(SmallObjectTest, OverAlignedObjectsKeepTheirAlignment) {
+
+    static_assert(alignof(OverAligned) > __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    std::vector<OverAligned*> objects;
+    for (int i = 0; i < 100; ++i) {
+        objects.push_back(new OverAligned());
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(objects.back()) % 64, 0u);
+    }
+    for (OverAligned* object : objects) {
+        delete object;
+    }
+
+    // Handlers of over-aligned callables, and their clones.
+    for (int i = 0; i < 100; ++i) {
+        auto lambda = [aligned = AlignedIncrement()](int x) {
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&aligned) % 64, 0u);
+            return aligned(x);
+        };
+        Functor<int, int> wrapped(lambda);
+        Functor<int, int> cloned = wrapped;
+        EXPECT_EQ(wrapped(i), i + 1);
+        EXPECT_EQ(cloned(i), i + 1);
+    }
+
+}
+
+
+TEST(SmallObjectTest, ThreadCacheBatchesTransfers) {
+
+    SmallObjAllocator central(4096, 64);
+    bool alive = true;
+    {
+        Cache cache(central, alive);
+
+        void* p = cache.allocate(16);
+        EXPECT_EQ(cache.cached_blocks(), Cache::batch_size - 1);
+        cache.deallocate(p, 16);
+        EXPECT_EQ(cache.allocate(16), p);   // Served locally.
+        cache.deallocate(p, 16);
+
+        // Blocks from another cache overflow this one back to the central allocator.
+        std::vector<void*> foreign;
+        {
+            bool other_alive = true;
+            Cache other(central, other_alive);
+            for (std::size_t i = 0; i < 3 * Cache::batch_size; ++i) {
+                foreign.push_back(other.allocate(16));
+            }
+        }
+        for (void* block : foreign) {
+            cache.deallocate(block, 16);
+        }
+        EXPECT_LE(cache.cached_blocks(), 2 * Cache::batch_size);
+
+        void* large = cache.allocate(1000);
+        cache.deallocate(large, 1000);
+    }
+    EXPECT_FALSE(alive);
+
+}
+
+
+TEST(SmallObjectTest, CrossThreadFreesReuseMemory) {
+
+    ThreadPool producer(1), consumer(1);
+    constexpr int n_rounds = 200, n_messages = 1000;
+
+    for (int round = 0; round < n_rounds; ++round) {
+        std::vector<Message*> messages = producer.submit([] {
+            std::vector<Message*> created;
+            for (int i = 0; i < n_messages; ++i) {
+                created.push_back(new Message());
+            }
+            return created;
+        }).get();
+
+        consumer.submit([&messages] {
+            for (Message* p : messages) {
+                delete p;
+            }
+        }).get();
+    }
+
+    // Freed blocks flow back to the producer rather than new slabs being carved.
+    std::size_t blocks_per_slab = 4096 / sizeof(Message);
+    EXPECT_LE(CachedObject::allocator().slab_count(), 2 * n_messages / blocks_per_slab + 2);
+
+}
@@ -0,0 +1,117 @@
+/*! @file type_id_test.cpp
+ *  @brief Tests for `TypeId` and `TypeName`, and the factories and dispatchers keyed on them.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/factory.hpp"
+#include "mosaic/utilities/multi_methods.hpp"
+#include "mosaic/utilities/type_id.hpp"
+
+using namespace mosaic;
+
+namespace shapes {
+
+    struct Shape {
+        virtual ~Shape() = default;
+        virtual std::uint64_t type_id() const = 0;
+        virtual std::string name() const = 0;
+    };
+
+    struct Circle : Shape {
+        MOSAIC_OVERRIDE_TYPE_ID(Circle)
+        std::string name() const override { return "circle"; }
+    };
+
+    struct Square : Shape {
+        MOSAIC_OVERRIDE_TYPE_ID(Square)
+        std::string name() const override { return "square"; }
+    };
+
+    // A concrete root defining `type_id()` itself.
+    struct Vehicle {
+        virtual ~Vehicle() = default;
+        MOSAIC_DEFINE_TYPE_ID(Vehicle)
+    };
+
+    struct Truck : Vehicle {
+        MOSAIC_OVERRIDE_TYPE_ID(Truck)
+    };
+
+    template <std::uint64_t id>
+    struct Tagged {
+        static constexpr std::uint64_t value = id;
+    };
+
+    std::string describe(const Shape& shape) {
+        switch (shape.type_id()) {
+            case TypeId<Circle>(): return "round";
+            case TypeId<Square>(): return "square";
+            default: return "unknown";
+        }
+    }
+
+} // end namespace `shapes`
+
+using namespace shapes;
+
+
+TEST(TypeIdTest, NamesAndIdsAreConstant) {
+
+    static_assert(TypeName<int>() == "int");
+    static_assert(TypeName<Circle>() == "shapes::Circle");
+    static_assert(TypeName<const Circle*>() == "const shapes::Circle*");
+    static_assert(TypeId<Circle>() != TypeId<Square>());
+    static_assert(TypeId<Circle>() != TypeId<const Circle>());
+    static_assert(Tagged<TypeId<Circle>()>::value == TypeId<Circle>());
+
+    // FNV-1a of "int".
+    EXPECT_EQ(TypeId<int>(), 0x2B9FFF192BD4C83Eull);
+
+}
+
+TEST(TypeIdTest, IdentifiesDynamicTypes) {
+
+    const std::unique_ptr<Shape> circle = std::make_unique<Circle>();
+    EXPECT_EQ(circle->type_id(), TypeId<Circle>());
+    EXPECT_EQ(describe(*circle), "round");
+    EXPECT_EQ(describe(Square()), "square");
+
+    Truck truck;
+    const Vehicle& vehicle = truck;
+    EXPECT_EQ(vehicle.type_id(), TypeId<Truck>());
+    EXPECT_EQ(Vehicle().type_id(), TypeId<Vehicle>());
+
+}
+
+TEST(TypeIdTest, KeysFactoriesAndDispatchers) {
+
+    Factory<Shape, std::uint64_t> factory;
+    factory.Register(TypeId<Circle>(), [] () -> Shape* { return new Circle; });
+    const std::unique_ptr<Shape> created(factory.CreateObject(TypeId<Circle>()));
+    EXPECT_EQ(created->name(), "circle");
+
+    CloneFactory<Shape, Shape* (*)(const Shape&), policies::DefaultFactoryError, policies::TypeIdKey> cloner;
+    EXPECT_TRUE(cloner.Register<Square>());
+    EXPECT_TRUE(cloner.IsRegistered(TypeId<Square>()));
+    const std::unique_ptr<Shape> copy(cloner.CreateObject(Square()));
+    EXPECT_EQ(copy->name(), "square");
+    using UnknownType = policies::DefaultFactoryError<std::uint64_t, Shape>::Exception;
+    EXPECT_THROW(cloner.CreateObject(Circle()), UnknownType);
+
+    using Dispatcher = BasicDispatcher<
+        Shape, Shape, std::string, std::string (*)(Shape&, Shape&),
+        policies::DefaultDispatcherError<Shape, Shape, std::string>, policies::TypeIdKey
+    >;
+    Dispatcher dispatcher;
+    dispatcher.Add<Circle, Square>([](Shape& lhs, Shape& rhs) { return lhs.name() + "-" + rhs.name(); });
+    Circle circle;
+    Square square;
+    EXPECT_EQ(dispatcher.Go(circle, square), "circle-square");
+    using UnknownTypes = policies::DefaultDispatcherError<Shape, Shape, std::string>::Exception;
+    EXPECT_THROW(dispatcher.Go(square, circle), UnknownTypes);
+
+}
@@ -0,0 +1,52 @@
+/*! @file type_info_test.cpp
+ *  @brief Tests for `TypeInfo`.
+ */
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/type_info.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    struct Base { virtual ~Base() = default; };
+    struct Derived : Base {};
+
+} // end anonymous namespace
+
+
+TEST(TypeInfoTest, ComparesWrappedTypes) {
+
+    const TypeInfo base = typeid(Base);
+    const TypeInfo derived = typeid(Derived);
+    const Base& object = Derived();
+
+    EXPECT_EQ(TypeInfo(typeid(object)), derived);
+    EXPECT_NE(base, derived);
+    EXPECT_NE(base < derived, derived < base);
+
+    TypeInfo copy;
+    copy = derived;
+    EXPECT_EQ(copy, derived);
+    EXPECT_EQ(copy.hash_code(), derived.hash_code());
+
+}
+
+TEST(TypeInfoTest, HashesLikeTypeInfo) {
+
+    EXPECT_EQ(TypeInfo(typeid(int)).hash_code(), typeid(int).hash_code());
+    EXPECT_EQ(std::hash<TypeInfo>()(typeid(Base)), typeid(Base).hash_code());
+
+    std::unordered_map<TypeInfo, std::string> names;
+    names[typeid(int)] = "int";
+    names[typeid(Base)] = "Base";
+    names[typeid(Derived)] = "Derived";
+
+    EXPECT_EQ(names.size(), 3u);
+    EXPECT_EQ(names.at(typeid(Derived)), "Derived");
+    EXPECT_EQ(names.count(typeid(double)), 0u);
+
+}
@@ -18,3 +18,14 @@ TEST(MakeTLTest, CreateCorrectTypelist) {
     << " instead of " << expected_typeinfo.name();
 
 }
+
+TEST(ReverseTest, ReversesTypes) {
+
+    using TL = typename mosaic::MakeTL<bool, char, int>::TL;
+    using Reversed = typename mosaic::tl::Reverse<TL>::Result;
+
+    EXPECT_EQ(typeid(Reversed), typeid(typename mosaic::MakeTL<int, char, bool>::TL));
+    EXPECT_EQ(typeid(typename mosaic::tl::Reverse<Reversed>::Result), typeid(TL));
+    EXPECT_EQ(typeid(typename mosaic::tl::Reverse<mosaic::NullType>::Result), typeid(mosaic::NullType));
+
+}
@@ -0,0 +1,252 @@
+/*! @file visitor_test.cpp
+ *  @brief Tests for the visitors.
+ */
+
+#include <forward_list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mosaic/utilities/visitor.hpp"
+
+using namespace mosaic;
+
+namespace {
+
+    class Circle;
+    class Square;
+    class RoundedSquare;
+
+    using ShapeVisitor = CyclicVisitor<void, MakeTL<Circle, Square, RoundedSquare>::TL>;
+    using AreaVisitor = CyclicVisitor<double, MakeTL<Circle, Square, RoundedSquare>::TL>;
+
+    struct Shape {
+        virtual ~Shape() = default;
+        virtual void Accept(ShapeVisitor&) = 0;
+        virtual double Accept(AreaVisitor&) = 0;
+    };
+
+    class Circle : public Shape {
+    public:
+        MOSAIC_DEFINE_CYCLIC_VISITABLE(ShapeVisitor)
+        MOSAIC_DEFINE_CYCLIC_VISITABLE(AreaVisitor)
+        double radius = 1.0;
+    };
+
+    class Square : public Shape {
+    public:
+        MOSAIC_DEFINE_CYCLIC_VISITABLE(ShapeVisitor)
+        MOSAIC_DEFINE_CYCLIC_VISITABLE(AreaVisitor)
+        double side = 2.0;
+    };
+
+    // Derives from a visitable class and is visited as itself.
+    class RoundedSquare : public Square {
+    public:
+        MOSAIC_DEFINE_CYCLIC_VISITABLE(ShapeVisitor)
+        MOSAIC_DEFINE_CYCLIC_VISITABLE(AreaVisitor)
+    };
+
+    struct NameVisitor : ShapeVisitor {
+        void Visit(Circle&) override { names += "circle "; }
+        void Visit(Square&) override { names += "square "; }
+        void Visit(RoundedSquare&) override { names += "rounded "; }
+        std::string names;
+    };
+
+    struct Area : AreaVisitor {
+        double Visit(Circle& c) override { return 3.0 * c.radius * c.radius; }
+        double Visit(Square& s) override { return s.side * s.side; }
+        double Visit(RoundedSquare& s) override { return s.side * s.side - 1.0; }
+    };
+
+} // end anonymous namespace
+
+
+TEST(CyclicVisitorTest, VisitsDynamicTypes) {
+
+    std::vector<std::unique_ptr<Shape>> shapes;
+    shapes.push_back(std::make_unique<Square>());
+    shapes.push_back(std::make_unique<Circle>());
+    shapes.push_back(std::make_unique<RoundedSquare>());
+
+    NameVisitor names;
+    for (auto& shape : shapes) {
+        shape->Accept(names);
+    }
+    EXPECT_EQ(names.names, "square circle rounded ");
+
+    Area area;
+    double total = 0.0;
+    for (auto& shape : shapes) {
+        total += shape->Accept(area);
+    }
+    EXPECT_DOUBLE_EQ(total, 4.0 + 3.0 + 3.0);
+
+}
+
+TEST(CyclicVisitorTest, GenericVisitSelectsTheExactUnit) {
+
+    RoundedSquare rounded;
+    NameVisitor names;
+    names.GenericVisit(rounded);
+    names.GenericVisit(static_cast<Square&>(rounded));
+    EXPECT_EQ(names.names, "rounded square ");
+
+}
+
+namespace {
+
+    struct Literal;
+    struct Add;
+    struct Mul;
+    struct Neg;
+
+    using ExprTypes = MakeTL<Literal, Add, Mul, Neg>::TL;
+
+    struct Expr : DenseVisitableBase<ExprTypes> {
+        virtual ~Expr() = default;
+    };
+
+    struct Literal : DenseVisitable<Literal, Expr> {
+        explicit Literal(int v) : value(v) {}
+        int value;
+    };
+
+    struct Binary : Expr {
+        Binary(std::unique_ptr<Expr> l, std::unique_ptr<Expr> r) : lhs(std::move(l)), rhs(std::move(r)) {}
+        std::unique_ptr<Expr> lhs;
+        std::unique_ptr<Expr> rhs;
+    };
+
+    struct Add : DenseVisitable<Add, Binary> {
+        using DenseVisitable::DenseVisitable;
+    };
+
+    struct Mul : DenseVisitable<Mul, Binary> {
+        using DenseVisitable::DenseVisitable;
+    };
+
+    // Derives from another visitable class.
+    struct Neg : DenseVisitable<Neg, Literal> {
+        explicit Neg(int v) : DenseVisitable(v) {}
+    };
+
+    struct Evaluate {
+        int Visit(const Literal& e) { return e.value; }
+        int Visit(const Add& e) { return DenseVisit(*this, std::as_const(*e.lhs)) + DenseVisit(*this, std::as_const(*e.rhs)); }
+        int Visit(const Mul& e) { return DenseVisit(*this, std::as_const(*e.lhs)) * DenseVisit(*this, std::as_const(*e.rhs)); }
+        int Visit(const Neg& e) { return -e.value; }
+    };
+
+    // A single overload for the base class covers both binary expressions.
+    struct CountNodes {
+        void Visit(Literal&) { ++count; }
+        void Visit(Binary& e) { ++count; DenseVisit(*this, *e.lhs); DenseVisit(*this, *e.rhs); }
+        int count = 0;
+    };
+
+    // Records the values of the literals it visits.
+    struct RecordLiterals {
+        void Visit(const Literal& e) { values.push_back(e.value); }
+        void Visit(const Binary&) { values.push_back(0); }
+        std::vector<int> values;
+    };
+
+    struct RecordLiteralsInOrder : RecordLiterals {
+        static constexpr VisitOrder visit_order = VisitOrder::preserve;
+    };
+
+} // end anonymous namespace
+
+
+TEST(DenseVisitTest, IndexesFollowTheTypelist) {
+
+    Literal literal(1);
+    Neg neg(2);
+    EXPECT_EQ(literal.type_index(), 0u);
+    EXPECT_EQ(neg.type_index(), 3u);
+    EXPECT_EQ(static_cast<const Literal&>(neg).type_index(), 3u);
+    static_assert(Mul::type_index_value == 2);
+
+    // Not in the typelist.
+    Binary binary(nullptr, nullptr);
+    EXPECT_EQ(binary.type_index(), 4u);
+
+}
+
+TEST(DenseVisitTest, AssertsOnMissingLayer) {
+
+#ifdef NDEBUG
+    GTEST_SKIP() << "Assertions are disabled";
+#endif
+
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+    Binary binary(nullptr, nullptr);
+    CountNodes count;
+    EXPECT_DEATH(DenseVisit(count, static_cast<Expr&>(binary)), "");
+
+}
+
+TEST(DenseVisitTest, DispatchesOnDynamicType) {
+
+    // (2 + -3) * 4
+    auto expr = std::make_unique<Mul>(
+        std::make_unique<Add>(std::make_unique<Literal>(2), std::make_unique<Neg>(3)),
+        std::make_unique<Literal>(4)
+    );
+
+    Evaluate evaluate;
+    const Expr& root = *expr;
+    EXPECT_EQ(DenseVisit(evaluate, root), -4);
+
+    CountNodes count;
+    DenseVisit(count, static_cast<Expr&>(*expr));
+    EXPECT_EQ(count.count, 5);
+
+}
+
+TEST(DenseVisitTest, VisitAllGroupsByType) {
+
+    std::vector<std::unique_ptr<Expr>> exprs;
+    exprs.push_back(std::make_unique<Neg>(1));
+    exprs.push_back(std::make_unique<Literal>(2));
+    exprs.push_back(std::make_unique<Add>(std::make_unique<Literal>(0), std::make_unique<Literal>(0)));
+    exprs.push_back(std::make_unique<Literal>(3));
+    exprs.push_back(std::make_unique<Neg>(4));
+
+    // Typelist order, stable within a type.
+    RecordLiterals grouped;
+    VisitAll(exprs, grouped);
+    EXPECT_EQ(grouped.values, (std::vector<int>{2, 3, 0, 1, 4}));
+
+    RecordLiterals preserved;
+    VisitAll(exprs, preserved, VisitOrder::preserve);
+    EXPECT_EQ(preserved.values, (std::vector<int>{1, 2, 0, 3, 4}));
+
+    // The visitor's own order is the default.
+    RecordLiteralsInOrder ordered;
+    VisitAll(exprs, ordered);
+    EXPECT_EQ(ordered.values, preserved.values);
+
+    std::vector<const Expr*> pointers;
+    for (const auto& expr : exprs) {
+        pointers.push_back(expr.get());
+    }
+    RecordLiterals from_pointers;
+    VisitAll(pointers, from_pointers);
+    EXPECT_EQ(from_pointers.values, grouped.values);
+
+    // Not sized.
+    std::forward_list<const Expr*> list(pointers.begin(), pointers.end());
+    RecordLiterals from_list;
+    VisitAll(list, from_list);
+    EXPECT_EQ(from_list.values, grouped.values);
+
+    RecordLiterals empty;
+    VisitAll(std::vector<Expr*>(), empty);
+    EXPECT_TRUE(empty.values.empty());
+
+}